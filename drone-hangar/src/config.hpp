@@ -17,9 +17,15 @@
 #define LCD_COL 20
 #define LCD_ROW 4
 
+/* ====== PIR CONFIG ====== */
+#define PIR_WARMUP_MS 10000  // Output is unreliable this long after power-up
+
 /* ====== DOOR CONFIG ====== */
 #define DOOR_OPEN_ANGLE 180
 #define MOVING_TIME 500
+#define SERVO_MOTION_SHAPE MOTION_SCURVE  // MOTION_TRAPEZOID or MOTION_SCURVE
+#define SERVO_RAMP_DIV 3                  // each ramp takes 1/3 of a move
+#define SERVO_IDLE_MS 400                 // servo detached this long after the last move or write
 
 /* ===== Distance thresholds (cm) ===== */
 #define D1 1.2  // Distance threshold for drone exit detection
@@ -40,6 +46,16 @@
 #define DISTANCE_TASK_PERIOD 50
 #define LCD_TASK_PERIOD 100
 #define MSG_TASK_PERIOD 50
+#define FSM_MAX_STEPS_PER_TICK 3  // Transitions a task FSM may chain in one tick
+#define LCD_FLUSH_MAX_US 8000     // LCD writes per tick, ~6 cells, even if the slot has more room
+
+/* ===== Device sampling periods (AcquisitionTask) ===== */
+#define TEMP_SAMPLE_PERIOD 200   // 5 ADC conversions per sample
+#define SONAR_SAMPLE_PERIOD 50   // Only while a landing/takeoff check runs
+
+/* ===== Interrupt-driven inputs ===== */
+#define BUTTON_DEBOUNCE_MS 30  // A level counts once the pin kept it this long
+#define SCHED_IDLE_SLEEP       // Idle-sleep between slots, any interrupt wakes the MCU
 
 // Temperature thresholds (Celsius)
 #define TEMP1 27  // Pre-alarm temperature threshold
@@ -85,11 +101,44 @@
 #define COMMAND "cmd"  // Command key in messages
 // Command values
 #define OPEN_CMD "open"  // Command value to open the hangar door
+#define DUMP_CMD "dump"  // Command value to dump the retained log entries
+#define RESET_CMD "reset"  // Command value to reset the alarm (same as the button)
+#define STATS_CMD "stats"  // Command value to report the internal counters
+#define JOURNAL_CMD "journal"  // Command value to export the EEPROM journal
+
+// Keys of the reply to STATS_CMD
+#define STATS_KEY "stats"        // Object holding the counters
+#define STATS_CMD_OVR "cmd_ovr"  // Commands rejected because the store was full
+#define STATS_CMD_EXP "cmd_exp"  // Commands expired before being consumed
+#define STATS_LOG_LOST "log_lost"  // Log entries overwritten before being sent
+#define STATS_IN_DROP "in_drop"    // PIR and button edges lost because the input queue was full
+#define STATS_RAM_FREE "ram_free"  // Bytes between the heap and the stack when the reply is built
+#define STATS_LCD "lcd"            // LCD [pending writes, last latency ms, max latency ms, coalesced frames]
 
 /* ===== Distance definitions ===== */
 #define DISTANCE_KEY "distance"  // Key for distance value in messages
 
 /* ===== Other definitions ===== */
 #define ALIVE "alive"  // Key indicating system is alive
+#define PIR_READY_KEY "pir_ready"  // false while the PIR warms up after a reset
+#define BOOT_KEY "boot"  // Boot profile sent once by setup(), us per phase
+
+/* ===== Protocol negotiation ===== */
+// The remote unit sends {"proto":"bin"}, the hangar answers with the same
+// JSON line and then switches to COBS framed binary messages.
+#define PROTO_KEY "proto"     // Key for protocol negotiation
+#define PROTO_BINARY "bin"    // Binary framed protocol
+#define PROTO_JSON "json"     // Default JSON lines protocol
+
+#define PARAM_GET_KEY "get"    // {"get":"<param>"} answers {"<param>":<value>}
+#define PARAM_SET_KEY "set"    // {"set":"<param>","val":<value>} stores it in EEPROM
+#define PARAM_VALUE_KEY "val"  // New value of PARAM_SET_KEY
+
+// {"hist":"<signal>","res":<0 1 s, 1 10 s, 2 1 min>} streams "hs:" lines, newest first
+#define HIST_KEY "hist"     // temp (0.1 degC), distance (mm), door (deg), alarm
+#define HIST_RES_KEY "res"  // Resolution of the window, 0 if missing
+
+#define LOG_MODULE_KEY "log"  // Key of the module whose log level is set
+#define LOG_LEVEL_KEY "lvl"   // 0 off, 1 error, 2 warn, 3 info, 4 debug
 
 #endif
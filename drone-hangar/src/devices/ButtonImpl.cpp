@@ -1,11 +1,64 @@
 #include "ButtonImpl.hpp"
 
+#include <avr/interrupt.h>
+
 #include "Arduino.h"
+#include "config.hpp"
+#include "kernel/InputEvents.hpp"
+
+#if RESET_PIN < 8 || RESET_PIN > 13
+#error "ButtonImpl only serves PCINT0 (pins 8-13), move RESET_PIN or add the vector"
+#endif
+
+ButtonImpl* ButtonImpl::instance = nullptr;
 
 ButtonImpl::ButtonImpl(int pin)
 {
     this->pin = pin;
+    this->inputReg = portInputRegister(digitalPinToPort(pin));
+    this->mask = digitalPinToBitMask(pin);
     pinMode(pin, INPUT);
+    this->pressed = digitalRead(pin) == HIGH;
+    this->level = this->pressed;
+    this->lastEdge = millis();
+
+    instance = this;
+    *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+    PCIFR = _BV(digitalPinToPCICRbit(pin));
+    *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+}
+
+void ButtonImpl::onChange()
+{
+    ButtonImpl* self = instance;
+    if (!self)
+        return;
+
+    // The level held until now may have been stable long enough
+    unsigned long now = millis();
+    self->settle(now);
+
+    bool level = (*self->inputReg & self->mask) != 0;
+    if (level == self->level)
+        return;  // another pin of the port
+    self->level = level;
+    self->lastEdge = now;
+}
+
+void ButtonImpl::settle(unsigned long now)
+{
+    if (level == pressed || now - lastEdge < BUTTON_DEBOUNCE_MS)
+        return;
+    pressed = level;
+    InputEvents.push(level ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, lastEdge);
+}
+
+bool ButtonImpl::isPressed()
+{
+    noInterrupts();
+    onChange();
+    interrupts();
+    return pressed;
 }
 
-bool ButtonImpl::isPressed() { return digitalRead(pin) == HIGH; }
+ISR(PCINT0_vect) { ButtonImpl::onChange(); }
@@ -1,20 +1,49 @@
 #ifndef __BUTTONIMPL__
 #define __BUTTONIMPL__
 
+#include <Arduino.h>
+
 #include "Button.hpp"
 
 /**
  * @brief Implementation of a button device.
  *
+ * Edges are caught by the pin change interrupt of the pin. A level is
+ * accepted once the pin kept it for BUTTON_DEBOUNCE_MS, then queued in
+ * InputEvents with the time it started, so a press is never missed
+ * whatever the period of the task reading it and a long bounce does not
+ * turn into a release and a press. Only one button, on a PORTB pin (8-13
+ * on the Uno), is served.
  */
 class ButtonImpl : public Button
 {
    public:
     ButtonImpl(int pin);
+
+    /**
+     * @brief Debounced state.
+     *
+     * Also accepts a level that became stable since the last pin change.
+     */
     bool isPressed() override;
 
+    /**
+     * @brief Pin change interrupt handler.
+     */
+    static void onChange();
+
    private:
+    static ButtonImpl* instance; /**< The one button served by the interrupt */
+
+    /** Accepts the raw level if it is stable since BUTTON_DEBOUNCE_MS. */
+    void settle(unsigned long now);
+
     int pin;
+    volatile uint8_t* inputReg;
+    uint8_t mask;
+    volatile bool pressed;           /**< Debounced level */
+    volatile bool level;             /**< Raw level at the last pin change */
+    volatile unsigned long lastEdge; /**< Time of the last raw change */
 };
 
 #endif
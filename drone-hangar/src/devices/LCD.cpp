@@ -3,6 +3,8 @@
 #include "config.hpp"
 #include "kernel/Logger.hpp"
 
+static_assert(LCD_SHADOW_SIZE <= 255, "cells are indexed with a uint8_t");
+
 #define MAX_WORDS 4
 #define MAX_WORD_LEN 10
 
@@ -11,21 +13,29 @@ LCD::LCD(uint8_t addr, uint8_t cols, uint8_t rows)
     _lcd = new LiquidCrystal_I2C(addr, cols, rows);
     _lcd->init();
     _lcd->backlight();
+    _lcd->clear();  // the glass now matches front
+    _addr = addr;
     _cols = cols;
-    _rows = rows;
+    _rows = cols * rows <= LCD_SHADOW_SIZE ? rows : LCD_SHADOW_SIZE / cols;
+    memset(front, ' ', sizeof(front));
+    memset(back, ' ', sizeof(back));
+    cursorRow = 0;
+    cursorCol = 0;
+    dirty = false;
+    changedSinceFlush = false;
+    lastWrites = 0;
+    lastMicros = 0;
+    lastLatency = 0;
+    maxLatency = 0;
+    coalesced = 0;
 }
 
-void LCD::print(const char* message)
+void LCD::layout(const char* message, uint8_t rows)
 {
-    this->clear();
+    memset(back, ' ', rows * _cols);
     if (message == nullptr || message[0] == '\0')
         return;
 
-    int maxChars = this->_cols * this->_rows;
-    (void)maxChars;  // keep if you want to add truncation logic later
-
-    _lcd->setCursor(0, 0);
-
     // Split into words safely (bounded buffers)
     char words[MAX_WORDS][MAX_WORD_LEN];
     int num_words = 0;
@@ -70,7 +80,7 @@ void LCD::print(const char* message)
     int current_line = 0;
     int current_line_chars = 0;
 
-    while (idx < num_words && current_line < this->_rows)
+    while (idx < num_words && current_line < rows)
     {
         size_t wlen = strlen(words[idx]);
 
@@ -78,23 +88,16 @@ void LCD::print(const char* message)
         {
             if ((int)wlen <= this->_cols)
             {
-                _lcd->print(words[idx]);
+                memcpy(&back[current_line * _cols], words[idx], wlen);
                 current_line_chars = (int)wlen;
                 idx++;
             }
             else
             {
-                // Word longer than a line: print a truncated prefix
-                char buf[33];
-                int tocopy =
-                    this->_cols < (int)sizeof(buf) - 1 ? this->_cols : (int)sizeof(buf) - 1;
-                strncpy(buf, words[idx], tocopy);
-                buf[tocopy] = '\0';
-                _lcd->print(buf);
+                // Word longer than a line: keep a truncated prefix
+                memcpy(&back[current_line * _cols], words[idx], _cols);
                 idx++;  // drop the rest of the long word
                 current_line++;
-                if (current_line < this->_rows)
-                    _lcd->setCursor(0, current_line);
                 current_line_chars = 0;
             }
         }
@@ -103,8 +106,7 @@ void LCD::print(const char* message)
             // Need a space before the next word
             if (current_line_chars + 1 + (int)wlen <= this->_cols)
             {
-                _lcd->print(" ");
-                _lcd->print(words[idx]);
+                memcpy(&back[current_line * _cols + current_line_chars + 1], words[idx], wlen);
                 current_line_chars += 1 + (int)wlen;
                 idx++;
             }
@@ -112,13 +114,178 @@ void LCD::print(const char* message)
             {
                 // move to next line
                 current_line++;
-                if (current_line >= this->_rows)
+                if (current_line >= rows)
                     break;
-                _lcd->setCursor(0, current_line);
                 current_line_chars = 0;
             }
         }
     }
 }
 
-void LCD::clear() { _lcd->clear(); }
\ No newline at end of file
+uint8_t LCD::render(bool fromBlank, bool apply, uint8_t limit)
+{
+    uint8_t writes = 0;
+    uint8_t curRow = fromBlank ? 0 : cursorRow;  // clear homes the cursor
+    uint8_t curCol = fromBlank ? 0 : cursorCol;
+
+    for (uint8_t i = 0; i < _rows * _cols; i++)
+    {
+        if (back[i] == (fromBlank ? ' ' : front[i]))
+            continue;
+        uint8_t row = i / _cols;
+        uint8_t col = i % _cols;
+        // A cursor move costs as much as rewriting one unchanged cell
+        bool move = row != curRow || col != curCol;
+        if (writes + move + 1 > limit)
+            break;
+        if (move)
+        {
+            if (apply)
+                _lcd->setCursor(col, row);
+            writes++;
+            curRow = row;
+            curCol = col;
+        }
+        if (apply)
+        {
+            _lcd->write(back[i]);
+            front[i] = back[i];
+        }
+        writes++;
+        curCol++;  // the HD44780 address does not follow the rows, never cross one
+    }
+
+    if (apply)
+    {
+        cursorRow = curRow;
+        cursorCol = curCol;
+    }
+    return writes;
+}
+
+void LCD::show(const char* message, uint8_t rows)
+{
+    this->layout(message, rows < _rows ? rows : _rows);
+    this->contentChanged();
+}
+
+void LCD::show(MessageId id, uint8_t rows)
+{
+    if (rows > _rows)
+        rows = _rows;
+    memset(back, ' ', rows * _cols);
+    for (uint8_t r = 0; r < rows; r++)
+    {
+        PGM_P text;
+        uint8_t len = messageLine(id, r, text);
+        if (len == 0)
+            break;
+        memcpy_P(&back[r * _cols], text, len < _cols ? len : _cols);
+    }
+    this->contentChanged();
+}
+
+void LCD::put(uint8_t row, uint8_t col, const char* text, uint8_t width)
+{
+    if (row >= _rows || col >= _cols)
+        return;
+    if (width > _cols - col)
+        width = _cols - col;
+    char* cell = &back[row * _cols + col];
+    uint8_t n = 0;
+    for (; n < width && text[n] != '\0'; n++)
+        cell[n] = text[n];
+    memset(cell + n, ' ', width - n);
+    this->contentChanged();
+}
+
+void LCD::contentChanged()
+{
+    if (dirty)
+    {
+        // The cells not flushed yet get the new content directly. Counted once per frame, and
+        // only if part of the previous content already went out.
+        if (!changedSinceFlush)
+            coalesced++;
+        changedSinceFlush = true;
+        return;
+    }
+    if (this->render(false, false, 0xFF) == 0)
+        return;
+    dirty = true;
+    changedSinceFlush = true;
+    dirtySince = millis();
+    updateWrites = 0;
+    updateMicros = 0;
+}
+
+bool LCD::flush(unsigned long budgetUs)
+{
+    changedSinceFlush = false;
+    if (!dirty)
+        return true;
+
+    unsigned long t0 = micros();
+    uint8_t pending = this->render(false, false, 0xFF);
+    // Blanking many cells is cheaper with a clear, despite its execution time. A clear that
+    // does not fit in the budget is not waited for: the cells are written one by one instead.
+    if (pending > 0 && budgetUs >= LCD_CLEAR_COST * LCD_WRITE_US &&
+        this->render(true, false, 0xFF) + LCD_CLEAR_COST < pending)
+    {
+        _lcd->clear();
+        memset(front, ' ', sizeof(front));
+        cursorRow = 0;
+        cursorCol = 0;
+        updateWrites++;
+        budgetUs -= LCD_CLEAR_COST * LCD_WRITE_US;
+    }
+
+    // At least one cell and its cursor move, or a budget that stays short would never end the update
+    unsigned long allowed = budgetUs / LCD_WRITE_US;
+    if (allowed < LCD_MIN_FLUSH_WRITES)
+        allowed = LCD_MIN_FLUSH_WRITES;
+    updateWrites += this->render(false, true, allowed > 0xFF ? 0xFF : (uint8_t)allowed);
+    updateMicros += micros() - t0;
+
+    if (this->render(false, false, 0xFF) > 0)
+        return false;
+
+    // Update complete
+    dirty = false;
+    lastWrites = updateWrites;
+    lastMicros = updateMicros > 0xFFFF ? 0xFFFF : (uint16_t)updateMicros;
+    unsigned long latency = millis() - dirtySince;
+    lastLatency = latency > 0xFFFF ? 0xFFFF : (uint16_t)latency;
+    if (lastLatency > maxLatency)
+        maxLatency = lastLatency;
+    Logger.log(LOG_LCD_I2C_BYTES, (int16_t)getLastI2CBytes());
+    Logger.log(LOG_LCD_UPDATE_US, (int16_t)(lastMicros > 0x7FFF ? 0x7FFF : lastMicros));
+    Logger.log(LOG_LCD_LATENCY_MS, (int16_t)(lastLatency > 0x7FFF ? 0x7FFF : lastLatency));
+    return true;
+}
+
+void LCD::print(const char* message)
+{
+    this->show(message);
+    this->flush(LCD_FLUSH_UNLIMITED);
+}
+
+void LCD::print(MessageId id)
+{
+    this->show(id);
+    this->flush(LCD_FLUSH_UNLIMITED);
+}
+
+void LCD::clear() { this->print(nullptr); }
+
+uint8_t LCD::getPendingWrites() { return this->render(false, false, 0xFF); }
+
+uint16_t LCD::getLastLatency() const { return lastLatency; }
+
+uint16_t LCD::getMaxLatency() const { return maxLatency; }
+
+uint16_t LCD::getCoalesced() const { return coalesced; }
+
+uint16_t LCD::getLastI2CBytes() const { return lastWrites * LCD_I2C_BYTES_PER_WRITE; }
+
+uint16_t LCD::getLastMicros() const { return lastMicros; }
\ No newline at end of file
@@ -4,9 +4,47 @@
 #include <Arduino.h>
 #include <LiquidCrystal_I2C.h>
 
+#include "config.hpp"
+#include "kernel/MessageCatalog.hpp"
+
+/** @brief Cells of the shadow buffers, the largest display supported. */
+#define LCD_SHADOW_SIZE (LCD_COL * LCD_ROW)
+
+/**
+ * @brief I2C bytes per HD44780 byte (char or command) through a PCF8574
+ * backpack: 2 nibbles x 3 expander writes x (address + data).
+ */
+#define LCD_I2C_BYTES_PER_WRITE 12
+
+/**
+ * @brief Cost of a clear in cell writes: one command plus its ~1.5 ms
+ * execution time.
+ */
+#define LCD_CLEAR_COST 3
+
+/** @brief Time of one HD44780 byte at 100 kHz, used to fit a flush in its budget. */
+#define LCD_WRITE_US 1300
+
+/** @brief HD44780 bytes a flush writes whatever its budget: one cell and a cursor move. */
+#define LCD_MIN_FLUSH_WRITES 2
+
+/** @brief Budget of a flush that must complete. */
+#define LCD_FLUSH_UNLIMITED 0xFFFFFFFFUL
+
 /**
  * @brief LCD display handler
  *
+ * Keeps a copy of what is on the glass, which costs as many I2C bytes to
+ * read back as to write. A new content is laid out in a back buffer, the
+ * one place where the message rows and the dashboard fields meet, and only
+ * the cells that differ are written, with a cursor move only where the
+ * changed cells are not contiguous. The display is
+ * cleared only when blanking the old content cell by cell would cost more.
+ *
+ * show() only lays the content out; flush() then writes as many cells as
+ * fit in a time budget, so a big change is spread over several calls. A
+ * content shown again before the flush ends replaces the pending one
+ * (coalescing): the cells are compared with the glass, not queued.
  */
 class LCD
 {
@@ -15,6 +53,33 @@ class LCD
     uint8_t _cols;
     uint8_t _rows;
     uint8_t _addr;
+    char front[LCD_SHADOW_SIZE]; /**< Content of the glass */
+    char back[LCD_SHADOW_SIZE];  /**< Content being laid out */
+    uint8_t cursorRow;           /**< Cursor position on the glass, homed by a clear */
+    uint8_t cursorCol;
+    bool dirty;                  /**< back differs from the glass */
+    bool changedSinceFlush;      /**< back was changed since the last flush() (same frame) */
+    unsigned long dirtySince;    /**< millis() of the show() that made it dirty */
+    uint16_t updateWrites;       /**< HD44780 bytes sent so far by the current update */
+    unsigned long updateMicros;  /**< Time spent so far in the current update */
+    uint16_t lastWrites;         /**< HD44780 bytes sent by the last update */
+    uint16_t lastMicros;         /**< Time spent writing the last update */
+    uint16_t lastLatency;        /**< ms from show() to the end of the last update */
+    uint16_t maxLatency;
+    uint16_t coalesced;          /**< Frames that replaced a partly shown content */
+
+    /** Word-wraps the message into the first rows of the back buffer. */
+    void layout(const char* message, uint8_t rows);
+
+    /** Starts an update, or coalesces with the one in progress. */
+    void contentChanged();
+
+    /**
+     * Walks the cells of the back buffer that differ from the glass (or
+     * from a blank glass) and returns the HD44780 bytes needed, at most
+     * limit. Writes them only if apply is true.
+     */
+    uint8_t render(bool fromBlank, bool apply, uint8_t limit);
 
    public:
     /**
@@ -27,17 +92,95 @@ class LCD
     LCD(uint8_t addr, uint8_t cols, uint8_t rows);
 
     /**
-     * @brief Print a message to the LCD, handling word wrapping
+     * @brief Print a message to the LCD, handling word wrapping. Blocks
+     * until the glass is updated.
      *
      * @param message The message to print
      */
     void print(const char* message);
 
     /**
-     * @brief Clear the LCD display
+     * @brief Print a catalog message with its precomputed layout. Blocks
+     * until the glass is updated.
+     *
+     * @param id The message to print
+     */
+    void print(MessageId id);
+
+    /**
+     * @brief Clear the LCD display. Blocks until the glass is updated.
      *
      */
     void clear();
+
+    /**
+     * @brief Lay a message out like print(), without writing anything.
+     *
+     * @param message The message to show
+     * @param rows Rows the message may use, the others are left as they are
+     */
+    void show(const char* message, uint8_t rows = 0xFF);
+
+    /**
+     * @brief Lay a catalog message out, without writing anything.
+     *
+     * The rows are copied from flash as computed at compile time, no word
+     * wrapping happens here.
+     *
+     * @param id The message to show
+     * @param rows Rows the message may use, the others are left as they are
+     */
+    void show(MessageId id, uint8_t rows = 0xFF);
+
+    /**
+     * @brief Set a fixed region of a row, without writing anything.
+     *
+     * @param row Row of the region
+     * @param col First column of the region
+     * @param text Text, truncated or padded with spaces to width
+     * @param width Cells of the region
+     */
+    void put(uint8_t row, uint8_t col, const char* text, uint8_t width);
+
+    /**
+     * @brief Write the pending cells that fit in the budget, at least one.
+     *
+     * @param budgetUs time the writes may take, in us
+     * @return true if the glass shows the last content
+     */
+    bool flush(unsigned long budgetUs);
+
+    /**
+     * @brief HD44780 bytes still needed to show the last content.
+     */
+    uint8_t getPendingWrites();
+
+    /**
+     * @brief ms from show() to the end of the last completed update.
+     */
+    uint16_t getLastLatency() const;
+
+    /**
+     * @brief Worst update latency since boot, in ms.
+     */
+    uint16_t getMaxLatency() const;
+
+    /**
+     * @brief Frames that replaced a content before it was completely shown.
+     *
+     * All the show() and put() calls between two flushes are one frame.
+     */
+    uint16_t getCoalesced() const;
+
+    /**
+     * @brief I2C bytes sent by the last completed update.
+     */
+    uint16_t getLastI2CBytes() const;
+
+    /**
+     * @brief Time spent writing the last update in us, all slices (saturated).
+     */
+    uint16_t getLastMicros() const;
 };
 
-#endif /* __LCD__ */
\ No newline at end of file
+#endif /* __LCD__ */
@@ -0,0 +1,84 @@
+#include "devices/MotionProfile.hpp"
+
+MotionProfile::MotionProfile() { hold(0); }
+
+void MotionProfile::hold(uint16_t position)
+{
+    pos = (int32_t)position << 16;
+    vel = 0;
+    acc = 0;
+    step = 0;
+    target = position;
+    frame = 0;
+    frames = 0;
+    ramp = 0;
+    shape = MOTION_TRAPEZOID;
+}
+
+void MotionProfile::start(uint16_t to, uint16_t frames, MotionShape shape, uint8_t rampDiv)
+{
+    uint16_t from = position();
+    uint16_t r = frames / rampDiv;
+    if (shape == MOTION_SCURVE)
+    {
+        r &= ~1;  // two halves
+        if (r == 0)
+            shape = MOTION_TRAPEZOID;
+    }
+    if (shape == MOTION_TRAPEZOID && r == 0 && frames >= 2)
+        r = 1;
+
+    hold(from);
+    if (to == from || r == 0)
+    {
+        hold(to);
+        return;
+    }
+
+    int32_t travel = (int32_t)to - from;
+    uint32_t unit = shape == MOTION_SCURVE ? (uint32_t)(r / 2) * (r / 2) * (frames - r) : (uint32_t)r * (frames - r);
+    this->step = travel * 65536L / (int32_t)unit;
+    this->target = to;
+    this->frames = frames;
+    this->ramp = r;
+    this->shape = shape;
+}
+
+bool MotionProfile::advance()
+{
+    if (frames == 0)
+        return false;
+
+    frame++;
+    if (shape == MOTION_SCURVE)
+    {
+        uint16_t half = ramp / 2;
+        if (frame <= half)
+            acc += step;
+        else if (frame <= ramp)
+            acc -= step;
+        else if (frame > frames - half)
+            acc += step;
+        else if (frame > frames - ramp)
+            acc -= step;
+        vel += acc;
+    }
+    else
+    {
+        if (frame <= ramp)
+            vel += step;
+        else if (frame > frames - ramp)
+            vel -= step;
+    }
+    pos += vel;
+
+    if (frame >= frames)
+        hold(target);  // drop the rounding error of step
+    return true;
+}
+
+uint16_t MotionProfile::position() const { return (uint16_t)((pos + 0x8000) >> 16); }
+
+uint16_t MotionProfile::getTarget() const { return target; }
+
+bool MotionProfile::isMoving() const { return frames != 0; }
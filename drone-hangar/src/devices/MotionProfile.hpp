@@ -0,0 +1,96 @@
+#ifndef __MOTION_PROFILE__
+#define __MOTION_PROFILE__
+
+#include <stdint.h>
+
+/*
+ * Motion profile of a servo, advanced once per servo frame.
+ *
+ * The position is integrated from the velocity and the velocity from the
+ * acceleration (trapezoid) or from the acceleration and the jerk (S-curve),
+ * all in 16.16 fixed point, so a frame costs a few 32-bit additions and no
+ * division. The per-frame step is computed once by start() so that the
+ * integrated travel ends exactly on the target:
+ *
+ *   trapezoid: ramp frames at +a, cruise, ramp frames at -a
+ *              travel = a * R * (N - R)
+ *   S-curve:   ramp split in two halves of H frames at +j then -j
+ *              (and mirrored at the end), travel = j * H^2 * (N - R)
+ *
+ * where N is the number of frames and R = 2H the frames of each ramp.
+ * Like BinaryProtocol.hpp, this header has no Arduino dependency so the
+ * profiles can be simulated on the host.
+ */
+
+/**
+ * @brief Shape of the velocity over a move.
+ */
+enum MotionShape : uint8_t
+{
+    MOTION_TRAPEZOID, /**< Constant acceleration ramps */
+    MOTION_SCURVE     /**< Jerk-limited ramps, no step in the acceleration */
+};
+
+/**
+ * @brief Position generator of one servo, in pulse width units.
+ */
+class MotionProfile
+{
+   private:
+    int32_t pos;       /**< Position, 16.16 */
+    int32_t vel;       /**< Per frame, 16.16 */
+    int32_t acc;       /**< Per frame^2, 16.16, S-curve only */
+    int32_t step;      /**< Acceleration (trapezoid) or jerk (S-curve) */
+    uint16_t target;
+    uint16_t frame;    /**< Frames done, 0 to frames */
+    uint16_t frames;   /**< Length of the move, 0 when holding */
+    uint16_t ramp;     /**< Frames of each ramp (R) */
+    MotionShape shape;
+
+   public:
+    MotionProfile();
+
+    /**
+     * @brief Stop any move and hold a position.
+     *
+     * @param position Position to hold.
+     */
+    void hold(uint16_t position);
+
+    /**
+     * @brief Start a move from the current position.
+     *
+     * Each ramp takes 1/rampDiv of the move. A move too short for the
+     * ramps ends on its first frame.
+     *
+     * @param to Target position.
+     * @param frames Duration of the move in frames.
+     * @param shape Velocity shape.
+     * @param rampDiv Fraction of the move spent in each ramp, at least 2.
+     */
+    void start(uint16_t to, uint16_t frames, MotionShape shape, uint8_t rampDiv);
+
+    /**
+     * @brief Advance by one frame, O(1). Meant for the servo ISR.
+     *
+     * @return true if the position changed.
+     */
+    bool advance();
+
+    /**
+     * @brief Position of the last frame, rounded.
+     */
+    uint16_t position() const;
+
+    /**
+     * @brief Target of the move, or the held position.
+     */
+    uint16_t getTarget() const;
+
+    /**
+     * @brief true while a move is in progress.
+     */
+    bool isMoving() const;
+};
+
+#endif
@@ -1,27 +1,62 @@
 #include "Pir.hpp"
 
 #include "Arduino.h"
+#include "config.hpp"
+#include "kernel/InputEvents.hpp"
+
+Pir* Pir::instance = nullptr;
 
 Pir::Pir(int pin)
 {
     this->pin = pin;
+    this->inputReg = portInputRegister(digitalPinToPort(pin));
+    this->mask = digitalPinToBitMask(pin);
     pinMode(pin, INPUT);
 }
 
+void Pir::onChange()
+{
+    Pir* self = instance;
+    bool level = (*self->inputReg & self->mask) != 0;
+    if (level == self->detected)
+        return;
+    unsigned long now = millis();
+    self->detected = level;
+    self->lastTimeSync = now;
+    InputEvents.push(level ? INPUT_PIR_RISE : INPUT_PIR_FALL, now);
+}
+
 void Pir::sync()
 {
+    detachInterrupt(digitalPinToInterrupt(pin));
     detected = digitalRead(pin) == HIGH;
     updateSyncTime(millis());
+    instance = this;
+    attachInterrupt(digitalPinToInterrupt(pin), Pir::onChange, CHANGE);
 }
 
-bool Pir::isDetected()
+bool Pir::isDetected() { return detected; }
+
+bool Pir::isReady()
 {
-    this->sync();
-    return detected;
+    if (!ready && millis() - warmUpStart >= PIR_WARMUP_MS)
+        ready = true;  // latched, millis() may wrap later
+    return ready;
 }
 
-void Pir::calibrate() { delay(10000); }
+void Pir::calibrate()
+{
+    warmUpStart = millis();
+    ready = false;
+    this->sync();
+}
 
 void Pir::updateSyncTime(long time) { lastTimeSync = time; }
 
-long Pir::getLastSyncTime() { return lastTimeSync; }
+long Pir::getLastSyncTime()
+{
+    noInterrupts();
+    long time = lastTimeSync;
+    interrupts();
+    return time;
+}
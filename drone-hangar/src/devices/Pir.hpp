@@ -1,19 +1,35 @@
 #ifndef __PIR__
 #define __PIR__
 
+#include <Arduino.h>
+
 #include "PresenceSensor.hpp"
 
 /**
  * @brief Class representing a (PIR) sensor.
  *
+ * The pin must have an external interrupt (2 or 3 on the Uno): every edge
+ * updates the state and is queued in InputEvents with its time, so
+ * isDetected() never touches the pin.
+ *
+ * After power-up the sensor needs PIR_WARMUP_MS before its output means
+ * anything; calibrate() only starts that time, isReady() tells when it is over.
  */
 class Pir : public PresenceSensor
 {
    public:
     Pir(int pin);
     bool isDetected() override;
+    bool isReady() override;
+
+    /**
+     * @brief Start the warm-up and follow the pin. Returns at once.
+     */
     void calibrate();
 
+    /**
+     * @brief Read the pin once and start following its edges.
+     */
     void sync();
     long getLastSyncTime();
 
@@ -21,9 +37,16 @@ class Pir : public PresenceSensor
     void updateSyncTime(long time);
 
    private:
-    long lastTimeSync;
+    static Pir* instance; /**< The one PIR served by the interrupt */
+    static void onChange();
+
+    volatile long lastTimeSync;
     int pin;
-    bool detected = false;
+    volatile uint8_t* inputReg;
+    uint8_t mask;
+    volatile bool detected = false;
+    unsigned long warmUpStart;
+    bool ready = false;
 };
 
 #endif
@@ -14,6 +14,13 @@ class PresenceSensor
      * @return true if presence is detected, false otherwise
      */
     virtual bool isDetected() = 0;
+
+    /**
+     * Check whether the sensor output can be trusted yet.
+     *
+     * @return true once the sensor has warmed up
+     */
+    virtual bool isReady() { return true; }
 };
 
 #endif
@@ -29,6 +29,29 @@ class ServoMotor
      */
     virtual void setPosition(int angle) = 0;
 
+    /**
+     * @brief Move to an angle along a smooth motion profile, from the
+     * current position. Returns at once, the motion runs in background.
+     *
+     * @param angle Target angle.
+     * @param durationMs Duration of the move.
+     */
+    virtual void moveTo(int angle, unsigned long durationMs) = 0;
+
+    /**
+     * @brief Check if a move started by moveTo() is in progress.
+     *
+     * @return true while moving
+     */
+    virtual bool isMoving() = 0;
+
+    /**
+     * @brief Angle commanded to the servo, updated during a move.
+     *
+     * @return int angle in degrees
+     */
+    virtual int getPosition() = 0;
+
     /**
      * @brief Turn the servo motor off.
      *
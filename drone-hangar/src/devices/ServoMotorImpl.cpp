@@ -1,21 +1,34 @@
 #include "ServoMotorImpl.hpp"
 
+#include "config.hpp"
+
+// updated values: min is 544, max 2400 (see ServoTimer2 doc)
+#define SERVO_MIN_US 544
+#define SERVO_RANGE_US (2400 - SERVO_MIN_US)
+#define SERVO_DEG_PER_US_Q16 6356  // 180 / SERVO_RANGE_US in 0.16 fixed point
+
 ServoMotorImpl::ServoMotorImpl(int pin)
 {
     this->pin = pin;
     _on = false;
 }
 
+#define SERVO_IDLE_FRAMES (SERVO_IDLE_MS * 1000UL / FRAME_SYNC_PERIOD)
+static_assert(SERVO_IDLE_FRAMES > 0 && SERVO_IDLE_FRAMES <= 255, "SERVO_IDLE_MS out of range");
+
 void ServoMotorImpl::on()
 {
     // updated values: min is 544, max 2400 (see ServoTimer2 doc)
     motor.attach(pin);  //, 544, 2400);
+    // Stop pulsing once settled; the next setPosition() or moveTo() resumes from the same
+    // pulse width, so the servo does not move when it is attached again
+    motor.detachWhenIdle(SERVO_IDLE_FRAMES);
     _on = true;
 }
 
 bool ServoMotorImpl::isOn() { return _on; }
 
-void ServoMotorImpl::setPosition(int angle)
+int ServoMotorImpl::toPulse(int angle)
 {
     if (angle > 180)
     {
@@ -25,11 +38,24 @@ void ServoMotorImpl::setPosition(int angle)
     {
         angle = 0;
     }
-    // 750 -> 0, 2250 -> 180
-    // 750 + angle*(2250-750)/180
-    // updated values: min is 544, max 2400 (see ServoTimer2 doc)
-    float coeff = (2400.0 - 544.0) / 180;
-    motor.write(544 + angle * coeff);
+    // 544 -> 0, 2400 -> 180, rounded
+    return SERVO_MIN_US + ((long)angle * SERVO_RANGE_US + 90) / 180;
+}
+
+void ServoMotorImpl::setPosition(int angle) { motor.write(toPulse(angle)); }
+
+void ServoMotorImpl::moveTo(int angle, unsigned long durationMs)
+{
+    unsigned long frames = durationMs * 1000UL / FRAME_SYNC_PERIOD;
+    motor.moveTo(toPulse(angle), frames > 0xFFFF ? 0xFFFF : frames, SERVO_MOTION_SHAPE, SERVO_RAMP_DIV);
+}
+
+bool ServoMotorImpl::isMoving() { return motor.moving(); }
+
+int ServoMotorImpl::getPosition()
+{
+    // inverse of toPulse() without a division, exact on whole angles
+    return ((unsigned long)(motor.position() - SERVO_MIN_US) * SERVO_DEG_PER_US_Q16 + 0x8000) >> 16;
 }
 
 void ServoMotorImpl::off()
@@ -18,9 +18,14 @@ class ServoMotorImpl : public ServoMotor
     void on() override;
     bool isOn() override;
     void setPosition(int angle) override;
+    void moveTo(int angle, unsigned long durationMs) override;
+    bool isMoving() override;
+    int getPosition() override;
     void off() override;
 
    private:
+    static int toPulse(int angle);
+
     int pin;
     bool _on;
     ServoTimer2 motor;
@@ -20,14 +20,66 @@ static void writeChan(uint8_t chan, int pulsewidth);
     8  // number of microseconds of calculation overhead to be subtracted from pulse timings
 
 static servo_t servos[NBR_CHANNELS + 1];  // static array holding servo data for all channels
+static MotionProfile* motions[NBR_CHANNELS + 1];  // motion profile of each channel
 
 static volatile uint8_t Channel;   // counter holding the channel being pulsed
 static volatile uint8_t ISRCount;  // iteration counter used in the interrupt routines;
 uint8_t ChannelCount = 0;          // counter holding the number of attached channels
 static boolean isStarted = false;  // flag to indicate if the ISR has been initialised
 
+#define MOTION_DELAY_TICKS 2  // timer ticks from the start of the frame sync to the motion interrupt
+
+#ifdef _SERVO_ISR_PROBE_
+// Each ISR holds a spare pin high while it runs, for a scope on the target. The pulse covers the
+// body only: the entry latency, the prologue and the epilogue come from the disassembly.
+#define PROBE_OVF_PIN 4    // PD4
+#define PROBE_COMPB_PIN 6  // PD6
+#define PROBE_HIGH(pin) (PORTD |= _BV(pin))
+#define PROBE_LOW(pin) (PORTD &= ~_BV(pin))
+#else
+#define PROBE_HIGH(pin)
+#define PROBE_LOW(pin)
+#endif
+
+// Once per frame, at the start of the frame sync period: no pulse is being timed, so the
+// channels can be rewritten. Kept out of the overflow ISR, which must not call functions
+// (a call makes it save every call-used register on each of its ~150 runs per frame).
+ISR(TIMER2_COMPB_vect)
+{
+    PROBE_HIGH(PROBE_COMPB_PIN);
+    TIMSK2 &= ~_BV(OCIE2B);  // one shot, armed again by the next frame
+    boolean active = false;
+    for (uint8_t chan = 1; chan <= ChannelCount; chan++)
+    {
+        servo_t& servo = servos[chan];
+        if (motions[chan] != nullptr && motions[chan]->advance())
+        {
+            writeChan(chan, motions[chan]->position());
+            servo.idle = 0;
+        }
+        else if (servo.Pin.isActive && servo.idleFrames > 0 && ++servo.idle >= servo.idleFrames)
+        {
+            servo.Pin.isActive = false;  // settled: no pulses, no holding torque
+            servo.Pin.isAsleep = true;
+        }
+        if (servo.Pin.isDetaching)
+        {
+            servo.Pin.isActive = false;
+            servo.Pin.isDetaching = false;
+        }
+        active |= servo.Pin.isActive;
+    }
+    if (!active)
+    {
+        TIMSK2 = 0;  // nothing to pulse: no more timer interrupts until a channel is attached
+        isStarted = false;
+    }
+    PROBE_LOW(PROBE_COMPB_PIN);
+}
+
 ISR(TIMER2_OVF_vect)
 {
+    PROBE_HIGH(PROBE_OVF_PIN);
     ++ISRCount;                               // increment the overlflow counter
     if (ISRCount == servos[Channel].counter)  // are we on the final iteration for this channel
     {
@@ -36,8 +88,8 @@ ISR(TIMER2_OVF_vect)
     else if (ISRCount > servos[Channel].counter)
     {
         // we have finished timing the channel so pulse it low and move on
-        if (servos[Channel].Pin.isActive == true)        // check if activated
-            digitalWrite(servos[Channel].Pin.nbr, LOW);  // pulse this channel low if active
+        if (servos[Channel].Pin.isActive == true)              // check if activated
+            *servos[Channel].port &= ~servos[Channel].mask;  // pulse this channel low if active
 
         Channel++;     // increment to the next channel
         ISRCount = 0;  // reset the isr iteration counter
@@ -45,45 +97,133 @@ ISR(TIMER2_OVF_vect)
         if ((Channel != FRAME_SYNC_INDEX) && (Channel <= NBR_CHANNELS))
         {                                              // check if we need to pulse this channel
             if (servos[Channel].Pin.isActive == true)  // check if activated
-                digitalWrite(servos[Channel].Pin.nbr,
-                             HIGH);  // its an active channel so pulse it high
+                *servos[Channel].port |= servos[Channel].mask;  // its an active channel so pulse it high
         }
         else if (Channel > NBR_CHANNELS)
         {
             Channel = 0;  // all done so start over
+            OCR2B = MOTION_DELAY_TICKS;
+            TIFR2 = _BV(OCF2B);     // drop a stale match
+            TIMSK2 |= _BV(OCIE2B);  // advance the motion profiles (see TIMER2_COMPB_vect)
         }
     }
+    PROBE_LOW(PROBE_OVF_PIN);
 }
 
 ServoTimer2::ServoTimer2()
 {
+    this->motion.hold(DEFAULT_PULSE_WIDTH);
     if (ChannelCount < NBR_CHANNELS)
-        this->chanIndex = ++ChannelCount;  // assign a channel number to this instance
+    {
+        this->chanIndex = ChannelCount + 1;  // assign a channel number to this instance
+        motions[this->chanIndex] = &this->motion;
+        ChannelCount++;  // the ISR may advance the channel from now on
+    }
     else
         this->chanIndex =
             0;  // todo	// too many channels, assigning 0 inhibits this instance from functioning
 }
 
+static void attachChan(uint8_t chan, int pin)
+{
+    pinMode(pin, OUTPUT);  // set servo pin to output
+    servos[chan].Pin.nbr = pin;
+    servos[chan].port = portOutputRegister(digitalPinToPort(pin));
+    servos[chan].mask = digitalPinToBitMask(pin);
+    servos[chan].idle = 0;
+    servos[chan].Pin.isAsleep = false;
+    servos[chan].Pin.isDetaching = false;
+    servos[chan].Pin.isActive = true;  // last, the ISR only uses port and mask of active channels
+}
+
+// Attaches a sleeping channel again, with the pulse width it had; interrupts must be disabled
+static void wakeChan(uint8_t chan)
+{
+    servos[chan].idle = 0;
+    if (servos[chan].Pin.isAsleep)
+    {
+        servos[chan].Pin.isAsleep = false;
+        servos[chan].Pin.isActive = true;
+        if (isStarted == false)
+            initISR();  // the first pulse follows the frame sync, never a partial one
+    }
+}
+
 uint8_t ServoTimer2::attach(int pin)
 {
+    noInterrupts();
     if (isStarted == false)
         initISR();
     if (this->chanIndex > 0)
     {
         // debug("attaching chan = ", chanIndex);
-        pinMode(pin, OUTPUT);  // set servo pin to output
-        servos[this->chanIndex].Pin.nbr = pin;
-        servos[this->chanIndex].Pin.isActive = true;
+        attachChan(this->chanIndex, pin);
     }
+    interrupts();
     return this->chanIndex;
 }
 
-void ServoTimer2::detach() { servos[this->chanIndex].Pin.isActive = false; }
+void ServoTimer2::detach()
+{
+    noInterrupts();
+    servos[this->chanIndex].Pin.isAsleep = false;
+    if (isStarted == false)
+        servos[this->chanIndex].Pin.isActive = false;  // no frame to wait for, the pin is low
+    else
+        servos[this->chanIndex].Pin.isDetaching = true;  // the frame interrupt clears isActive
+    interrupts();
+}
+
+void ServoTimer2::detachWhenIdle(uint8_t frames)
+{
+    noInterrupts();
+    servos[this->chanIndex].idleFrames = frames;
+    servos[this->chanIndex].idle = 0;
+    interrupts();
+}
 
 void ServoTimer2::write(int pulsewidth)
 {
+    if (pulsewidth < MIN_PULSE_WIDTH)
+        pulsewidth = MIN_PULSE_WIDTH;
+    else if (pulsewidth > MAX_PULSE_WIDTH)
+        pulsewidth = MAX_PULSE_WIDTH;
+    noInterrupts();
+    this->motion.hold(pulsewidth);  // cancels a move in progress
     writeChan(this->chanIndex,
               pulsewidth);  // call the static function to store the data for this servo
+    wakeChan(this->chanIndex);
+    interrupts();
+}
+
+void ServoTimer2::moveTo(int pulsewidth, uint16_t frames, MotionShape shape, uint8_t rampDiv)
+{
+    if (pulsewidth < MIN_PULSE_WIDTH)
+        pulsewidth = MIN_PULSE_WIDTH;
+    else if (pulsewidth > MAX_PULSE_WIDTH)
+        pulsewidth = MAX_PULSE_WIDTH;
+    noInterrupts();
+    this->motion.start(pulsewidth, frames, shape, rampDiv);
+    if (!this->motion.isMoving())
+        writeChan(this->chanIndex, pulsewidth);  // too short for a profile, jump
+    wakeChan(this->chanIndex);
+    interrupts();
+}
+
+boolean ServoTimer2::moving()
+{
+    noInterrupts();
+    boolean m = this->motion.isMoving();
+    interrupts();
+    return m;
+}
+
+int ServoTimer2::position()
+{
+    noInterrupts();
+    int p = this->motion.position();
+    interrupts();
+    return p;
 }
 
 int ServoTimer2::read()
@@ -97,7 +237,77 @@ int ServoTimer2::read()
     return pulsewidth;
 }
 
-boolean ServoTimer2::attached() { return servos[this->chanIndex].Pin.isActive; }
+boolean ServoTimer2::attached()
+{
+    // a sleeping channel stays attached for the caller
+    servo_t& servo = servos[this->chanIndex];
+    return (servo.Pin.isActive || servo.Pin.isAsleep) && !servo.Pin.isDetaching;
+}
+
+ServoArrayT2::ServoArrayT2()
+{
+    this->chanIndex = 0;
+    this->count = 0;
+}
+
+uint8_t ServoArrayT2::attach(int pin)
+{
+    noInterrupts();
+    if (isStarted == false)
+        initISR();
+    // channels of the array must be consecutive: attach them one after another
+    if (ChannelCount >= NBR_CHANNELS ||
+        (this->count > 0 && ChannelCount != this->chanIndex + this->count - 1))
+    {
+        interrupts();
+        return 0;
+    }
+    if (this->count == 0)
+        this->chanIndex = ChannelCount + 1;
+    attachChan(ChannelCount + 1, pin);
+    ChannelCount++;  // no motion profile: the frame interrupt skips the channel
+    interrupts();
+    return ++this->count;
+}
+
+uint8_t ServoArrayT2::channel(int chan)
+{
+    return (chan >= 1 && chan <= this->count) ? this->chanIndex + chan - 1 : 0;
+}
+
+void ServoArrayT2::detach(int chan)
+{
+    uint8_t c = this->channel(chan);
+    if (c == 0)
+        return;
+    noInterrupts();
+    if (isStarted == false)
+        servos[c].Pin.isActive = false;  // no frame to wait for, the pin is low
+    else
+        servos[c].Pin.isDetaching = true;  // the frame interrupt clears isActive
+    interrupts();
+}
+
+void ServoArrayT2::write(int chan, int pulsewidth)
+{
+    noInterrupts();
+    writeChan(this->channel(chan), pulsewidth);
+    interrupts();
+}
+
+int ServoArrayT2::read(int chan)
+{
+    uint8_t c = this->channel(chan);
+    if (c == 0)
+        return 0;
+    return servos[c].counter * 128 + ((255 - servos[c].remainder) / 2) + DELAY_ADJUST;
+}
+
+boolean ServoArrayT2::attached(int chan)
+{
+    uint8_t c = this->channel(chan);
+    return c > 0 && servos[c].Pin.isActive && !servos[c].Pin.isDetaching;
+}
 
 static void writeChan(uint8_t chan, int pulsewidth)
 {
@@ -120,11 +330,20 @@ static void writeChan(uint8_t chan, int pulsewidth)
 
 static void initISR()
 {
-    for (uint8_t i = 1; i <= NBR_CHANNELS; i++)
-    {                                       // channels start from 1
-        writeChan(i, DEFAULT_PULSE_WIDTH);  // store default values
+    static boolean isInitialised = false;  // restarts keep the pulse widths
+    if (isInitialised == false)
+    {
+        for (uint8_t i = 1; i <= NBR_CHANNELS; i++)
+        {                                       // channels start from 1
+            writeChan(i, DEFAULT_PULSE_WIDTH);  // store default values
+        }
+        servos[FRAME_SYNC_INDEX].counter = FRAME_SYNC_DELAY;  // store the frame sync period
+#ifdef _SERVO_ISR_PROBE_
+        pinMode(PROBE_OVF_PIN, OUTPUT);
+        pinMode(PROBE_COMPB_PIN, OUTPUT);
+#endif
+        isInitialised = true;
     }
-    servos[FRAME_SYNC_INDEX].counter = FRAME_SYNC_DELAY;  // store the frame sync period
 
     Channel = 0;   // clear the channel index
     ISRCount = 0;  // clear the value of the ISR counter;
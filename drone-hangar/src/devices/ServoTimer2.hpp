@@ -65,6 +65,10 @@ write() method
 
 The library takes about 824 bytes of program memory and 32+(1*servos) bytes of SRAM.
 
+The ISR sets the pins through the output register and bit mask resolved by attach(), instead of
+digitalWrite(). Channels are only detached between two frames, so a pulse is never cut, and the
+timer interrupts stop while no channel is attached.
+
 The pulse width timing is accurate to within 1%
 
 
@@ -75,6 +79,8 @@ The pulse width timing is accurate to within 1%
 #define ServoTimer2_h
 
 #include <inttypes.h>
+
+#include "MotionProfile.hpp"
 // typedef uint8_t boolean;
 // typedef uint8_t byte;
 
@@ -98,16 +104,28 @@ typedef struct
 
     uint8_t isActive : 1;  // false if this channel not enabled, pin only pulsed if true
 
+    uint8_t isAsleep : 1;  // detached because idle, attached again by the next write or move
+
+    uint8_t isDetaching : 1;  // detach requested, done between two frames
+
 } ServoPin_t;
 
 typedef struct
 {
     ServoPin_t Pin;
 
+    volatile uint8_t* port;  // output register of the pin, resolved by attach()
+
+    uint8_t mask;  // bit of the pin in port
+
     byte counter;
 
     byte remainder;
 
+    uint8_t idleFrames;  // frames without motion before the channel sleeps, 0 never
+
+    uint8_t idle;  // frames without motion so far
+
 } servo_t;
 
 class ServoTimer2
@@ -120,16 +138,26 @@ class ServoTimer2
                           // channel number or 0 if failure the attached servo is pulsed with the
                           // current pulse width value, (see the write method)
     // uint8_t attach(int, int, int); // as above but also sets min and max values for writes.
-    void detach();
+    void detach();       // stops pulsing the pin at the end of the current frame
+    void detachWhenIdle(uint8_t);  // stop pulsing after the given frames without motion (0 never);
+                                   // the next write or move pulses again from the last pulse width
     void write(int);     // store the pulse width in microseconds (between MIN_PULSE_WIDTH and
                          // MAX_PULSE_WIDTH)for this channel
     int read();          // returns current pulse width in microseconds for this servo
     boolean attached();  // return true if this servo is attached
+
+    void moveTo(int pulsewidth, uint16_t frames, MotionShape shape,
+                uint8_t rampDiv);  // move from the current pulse width along a profile,
+                                   // advanced by the ISR once per frame (see MotionProfile)
+    boolean moving();    // return true while a move started by moveTo is in progress
+    int position();      // pulse width sent on the last frame (or stored by write)
    private:
     uint8_t chanIndex;  // index into the channel data for this servo
+    MotionProfile motion;
 };
 
-// the following ServoArrayT2 class is not implemented in the first version of this library
+// ServoArrayT2 drives several servos with one object, in the same frame as the ServoTimer2 ones.
+// Its channels are written directly (no motion profile).
 class ServoArrayT2
 {
    public:
@@ -146,7 +174,9 @@ class ServoArrayT2
     int read(int);          // returns current pulse width in microseconds for the given channel
     boolean attached(int);  // return true if the servo on the given channel is attached
    private:
-    uint8_t chanIndex;  // index into the channel data for this servo
+    uint8_t chanIndex;  // index into the channel data of the first servo, 0 if none
+    uint8_t count;      // number of channels of the array
+    uint8_t channel(int);  // index into the channel data of a channel of the array, 0 if invalid
 };
 
 #endif
@@ -0,0 +1,190 @@
+#include "BinaryProtocol.hpp"
+
+#define FRAME_HEADER_SIZE 2
+#define FRAME_CRC_SIZE 2
+
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc)
+{
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t codePos = 0;
+    size_t outPos = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (in[i] == 0)
+        {
+            out[codePos] = code;
+            codePos = outPos++;
+            code = 1;
+        }
+        else
+        {
+            out[outPos++] = in[i];
+            if (++code == 0xFF)
+            {
+                out[codePos] = code;
+                codePos = outPos++;
+                code = 1;
+            }
+        }
+    }
+    out[codePos] = code;
+    return outPos;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    size_t inPos = 0;
+    size_t outPos = 0;
+
+    while (inPos < len)
+    {
+        uint8_t code = in[inPos++];
+        if (code == 0 || inPos + code - 1 > len)
+            return 0;
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (in[inPos] == 0)
+                return 0;
+            out[outPos++] = in[inPos++];
+        }
+        if (code != 0xFF && inPos < len)
+            out[outPos++] = 0;
+    }
+    return outPos;
+}
+
+/* ===================== FrameWriter ===================== */
+
+FrameWriter::FrameWriter(uint8_t* buf, size_t cap, uint8_t type, uint8_t seq)
+    : buf(buf), cap(cap), len(0), ok(cap >= FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+{
+    if (ok)
+    {
+        buf[len++] = type;
+        buf[len++] = seq;
+    }
+}
+
+void FrameWriter::putRaw(uint8_t id, uint32_t value, uint8_t width)
+{
+    if (!ok || len + 1 + width + FRAME_CRC_SIZE > cap)
+    {
+        ok = false;
+        return;
+    }
+    buf[len++] = id;
+    for (uint8_t i = 0; i < width; i++)
+    {
+        buf[len++] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+void FrameWriter::putU8(uint8_t id, uint8_t value) { putRaw(id, value, 1); }
+
+void FrameWriter::putU16(uint8_t id, uint16_t value) { putRaw(id, value, 2); }
+
+void FrameWriter::putI16(uint8_t id, int16_t value) { putRaw(id, (uint16_t)value, 2); }
+
+void FrameWriter::putU32(uint8_t id, uint32_t value) { putRaw(id, value, 4); }
+
+void FrameWriter::putBytes(uint8_t id, const uint8_t* data, uint8_t n)
+{
+    // Truncate rather than drop the whole frame: used for log text
+    if (ok && len + 2 + n + FRAME_CRC_SIZE > cap)
+    {
+        n = (len + 2 + FRAME_CRC_SIZE < cap) ? (uint8_t)(cap - len - 2 - FRAME_CRC_SIZE) : 0;
+    }
+    putRaw(id, n, 1);
+    if (!ok)
+        return;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        buf[len++] = data[i];
+    }
+}
+
+size_t FrameWriter::finish()
+{
+    if (!ok)
+        return 0;
+    uint16_t crc = crc16(buf, len);
+    buf[len++] = (uint8_t)crc;
+    buf[len++] = (uint8_t)(crc >> 8);
+    return len;
+}
+
+/* ===================== FrameReader ===================== */
+
+FrameReader::FrameReader(const uint8_t* buf, size_t len) : buf(buf), len(len), pos(FRAME_HEADER_SIZE)
+{
+}
+
+bool FrameReader::isValid() const
+{
+    if (len < FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+        return false;
+    size_t body = len - FRAME_CRC_SIZE;
+    uint16_t expected = (uint16_t)buf[body] | ((uint16_t)buf[body + 1] << 8);
+    return crc16(buf, body) == expected;
+}
+
+uint8_t FrameReader::type() const { return buf[0]; }
+
+uint8_t FrameReader::seq() const { return buf[1]; }
+
+bool FrameReader::next(uint8_t& id, uint32_t& value, const uint8_t*& data, uint8_t& n)
+{
+    size_t end = len - FRAME_CRC_SIZE;
+    if (pos >= end)
+        return false;
+
+    id = buf[pos++];
+    uint8_t width;
+    switch (id & FIELD_WIDTH_MASK)
+    {
+        case FIELD_WIDTH_1:
+            width = 1;
+            break;
+        case FIELD_WIDTH_2:
+            width = 2;
+            break;
+        case FIELD_WIDTH_4:
+            width = 4;
+            break;
+        default:
+            if (pos >= end)
+                return false;
+            n = buf[pos++];
+            if (pos + n > end)
+                return false;
+            data = &buf[pos];
+            value = n;
+            pos += n;
+            return true;
+    }
+
+    if (pos + width > end)
+        return false;
+    value = 0;
+    for (uint8_t i = 0; i < width; i++)
+    {
+        value |= (uint32_t)buf[pos++] << (8 * i);
+    }
+    data = nullptr;
+    n = 0;
+    return true;
+}
@@ -0,0 +1,193 @@
+#ifndef __BINARY_PROTOCOL__
+#define __BINARY_PROTOCOL__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Compact binary protocol used as an alternative to the JSON lines.
+ *
+ * This header has no Arduino dependency on purpose: the same codec is
+ * compiled by host-side tools that talk to the hangar.
+ *
+ * Raw frame layout (little-endian):
+ *
+ *   [type:u8][seq:u8][field]...[field][crc16:u16]
+ *
+ * Each field starts with a one byte id. The two most significant bits
+ * of the id encode the width of the value that follows, so a decoder
+ * can always skip fields it does not know:
+ *
+ *   00 -> 1 byte, 01 -> 2 bytes, 10 -> 4 bytes, 11 -> u8 length + bytes
+ *
+ * The CRC is CRC-16/CCITT-FALSE over type, seq and fields. On the wire
+ * the raw frame is COBS encoded and terminated by a single 0x00.
+ */
+
+/** @brief Maximum size of a raw (decoded) frame, CRC included. */
+#define FRAME_MAX_SIZE 48
+
+/** @brief Worst case size of a COBS encoded frame, delimiter excluded. */
+#define FRAME_MAX_ENCODED (FRAME_MAX_SIZE + FRAME_MAX_SIZE / 254 + 1)
+
+#define FIELD_WIDTH_1 0x00
+#define FIELD_WIDTH_2 0x40
+#define FIELD_WIDTH_4 0x80
+#define FIELD_WIDTH_VAR 0xC0
+#define FIELD_WIDTH_MASK 0xC0
+
+/**
+ * @brief Kind of frame, first byte of every raw frame.
+ */
+enum FrameType : uint8_t
+{
+    FRAME_HELLO = 0x01,   /**< Protocol negotiation (switch back to JSON) */
+    FRAME_STATUS = 0x10,  /**< Periodic hangar/drone status */
+    FRAME_COMMAND = 0x20, /**< Command from the remote unit */
+    FRAME_LOG = 0x30,     /**< Log entry */
+    FRAME_ACK = 0x40,     /**< Acknowledgement of a command frame */
+    FRAME_STATS = 0x50,   /**< Internal counters, answer to the STATS command */
+    FRAME_PARAM = 0x60,   /**< Value of a parameter, answer to a get/set */
+    FRAME_JOURNAL = 0x70, /**< Journal records, an empty one ends the export */
+    FRAME_HISTORY = 0x80  /**< History buckets, an empty one ends the window */
+};
+
+/**
+ * @brief Field identifiers. The width is part of the id.
+ */
+enum FieldId : uint8_t
+{
+    FIELD_HANGAR = FIELD_WIDTH_1 | 0x01,      /**< 0 normal, 1 pre-alarm, 2 alarm */
+    FIELD_DRONE = FIELD_WIDTH_1 | 0x02,       /**< Drone FSM state */
+    FIELD_ALIVE = FIELD_WIDTH_1 | 0x03,       /**< Heartbeat */
+    FIELD_CMD = FIELD_WIDTH_1 | 0x04,         /**< CommandType code */
+    FIELD_RESULT = FIELD_WIDTH_1 | 0x05,      /**< 1 accepted, 0 rejected */
+    FIELD_ACK_SEQ = FIELD_WIDTH_1 | 0x06,     /**< Sequence number being acked */
+    FIELD_PROTO = FIELD_WIDTH_1 | 0x07,       /**< 0 JSON, 1 binary */
+    FIELD_LOG_ID = FIELD_WIDTH_1 | 0x08,      /**< LogId of a catalog message */
+    FIELD_LOG_MODULE = FIELD_WIDTH_1 | 0x09,  /**< LogModule whose level is set */
+    FIELD_LOG_LEVEL = FIELD_WIDTH_1 | 0x0A,   /**< New LogLevel of FIELD_LOG_MODULE */
+    FIELD_PARAM_ID = FIELD_WIDTH_1 | 0x0B,    /**< ParamId to get, or to set with FIELD_PARAM_VALUE */
+    FIELD_HIST_SIGNAL = FIELD_WIDTH_1 | 0x0C, /**< HistorySignal to stream */
+    FIELD_HIST_RES = FIELD_WIDTH_1 | 0x0D,    /**< HistoryLevel of FIELD_HIST_SIGNAL */
+    FIELD_PIR_READY = FIELD_WIDTH_1 | 0x0E,   /**< 0 while the PIR warms up */
+    FIELD_IN_DROP = FIELD_WIDTH_1 | 0x0F,     /**< Input edges lost, queue full */
+    FIELD_LCD_PENDING = FIELD_WIDTH_1 | 0x10, /**< HD44780 bytes still to write */
+    FIELD_DISTANCE = FIELD_WIDTH_2 | 0x01,    /**< Distance in mm, signed */
+    FIELD_LOG_ARG = FIELD_WIDTH_2 | 0x02,     /**< Optional argument of a catalog message */
+    FIELD_CMD_OVR = FIELD_WIDTH_2 | 0x03,     /**< Commands rejected, store full */
+    FIELD_CMD_EXP = FIELD_WIDTH_2 | 0x04,     /**< Commands expired before use */
+    FIELD_LOG_LOST = FIELD_WIDTH_2 | 0x05,    /**< Log entries lost */
+    FIELD_PARAM_VALUE = FIELD_WIDTH_2 | 0x06, /**< Value of FIELD_PARAM_ID */
+    FIELD_RAM_FREE = FIELD_WIDTH_2 | 0x07,    /**< Bytes between the heap and the stack */
+    FIELD_LCD_LATENCY = FIELD_WIDTH_2 | 0x08, /**< ms from show() to the glass, last update */
+    FIELD_LCD_LAT_MAX = FIELD_WIDTH_2 | 0x09, /**< Worst FIELD_LCD_LATENCY since boot */
+    FIELD_LCD_COAL = FIELD_WIDTH_2 | 0x0A,    /**< LCD frames replaced before fully shown */
+    FIELD_TIMESTAMP = FIELD_WIDTH_4 | 0x01,   /**< millis() of the sender */
+    FIELD_TEXT = FIELD_WIDTH_VAR | 0x01,      /**< Free text (logs) */
+    FIELD_JOURNAL = FIELD_WIDTH_VAR | 0x02,   /**< Journal record: delta u16, subsystem, old:4|new:4 */
+    FIELD_HISTORY = FIELD_WIDTH_VAR | 0x03    /**< History bucket: index u8, min/max/avg i16 */
+};
+
+/**
+ * @brief Computes a CRC-16/CCITT-FALSE (poly 0x1021).
+ *
+ * @param data bytes to process
+ * @param len number of bytes
+ * @param crc initial value, pass a previous result to continue a CRC
+ * @return uint16_t the updated CRC
+ */
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief COBS-encodes a buffer. The output contains no zero byte.
+ *
+ * @param in raw bytes
+ * @param len number of raw bytes
+ * @param out destination, at least len + len / 254 + 1 bytes
+ * @return size_t number of encoded bytes
+ */
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * @brief Decodes a COBS buffer (without the trailing delimiter).
+ *
+ * @param in encoded bytes
+ * @param len number of encoded bytes
+ * @param out destination, at least len bytes
+ * @return size_t number of decoded bytes, 0 if the input is malformed
+ */
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * @brief Builds a raw frame field by field into a caller provided buffer.
+ */
+class FrameWriter
+{
+   private:
+    uint8_t* buf;
+    size_t cap;
+    size_t len;
+    bool ok;
+
+    void putRaw(uint8_t id, uint32_t value, uint8_t width);
+
+   public:
+    /**
+     * @param buf destination buffer
+     * @param cap size of the buffer, CRC included
+     * @param type frame type
+     * @param seq sequence number
+     */
+    FrameWriter(uint8_t* buf, size_t cap, uint8_t type, uint8_t seq);
+
+    void putU8(uint8_t id, uint8_t value);
+    void putU16(uint8_t id, uint16_t value);
+    void putI16(uint8_t id, int16_t value);
+    void putU32(uint8_t id, uint32_t value);
+    void putBytes(uint8_t id, const uint8_t* data, uint8_t n);
+
+    /**
+     * @brief Appends the CRC.
+     *
+     * @return size_t size of the raw frame, 0 if the buffer overflowed
+     */
+    size_t finish();
+};
+
+/**
+ * @brief Iterates over the fields of a raw frame.
+ */
+class FrameReader
+{
+   private:
+    const uint8_t* buf;
+    size_t len;
+    size_t pos;
+
+   public:
+    /**
+     * @brief Validates length and CRC of a raw frame.
+     *
+     * @param buf raw frame, CRC included
+     * @param len size of the raw frame
+     */
+    FrameReader(const uint8_t* buf, size_t len);
+
+    /** @return true if the frame is well formed and the CRC matches */
+    bool isValid() const;
+    uint8_t type() const;
+    uint8_t seq() const;
+
+    /**
+     * @brief Reads the next field.
+     *
+     * Fixed width values are returned in @p value, variable ones through
+     * @p data / @p n (the data is not copied).
+     *
+     * @return true if a field was read, false at the end of the frame
+     */
+    bool next(uint8_t& id, uint32_t& value, const uint8_t*& data, uint8_t& n);
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "kernel/BootProfile.hpp"
+
+#include "config.hpp"
+#include "kernel/MsgService.hpp"
+
+static const char BOOT_NAME_RESET[] PROGMEM = "\"reset\":";
+static const char BOOT_NAME_SERIAL[] PROGMEM = ",\"serial\":";
+static const char BOOT_NAME_STORAGE[] PROGMEM = ",\"storage\":";
+static const char BOOT_NAME_DEVICES[] PROGMEM = ",\"devices\":";
+static const char BOOT_NAME_LCD[] PROGMEM = ",\"lcd\":";
+static const char BOOT_NAME_SERVO[] PROGMEM = ",\"servo\":";
+static const char BOOT_NAME_PIR[] PROGMEM = ",\"pir\":";
+static const char BOOT_NAME_TASKS[] PROGMEM = ",\"tasks\":";
+static const char* const BOOT_NAMES[BOOT_PHASES] PROGMEM = {
+    BOOT_NAME_RESET, BOOT_NAME_SERIAL, BOOT_NAME_STORAGE, BOOT_NAME_DEVICES,
+    BOOT_NAME_LCD,   BOOT_NAME_SERVO,  BOOT_NAME_PIR,     BOOT_NAME_TASKS};
+
+BootProfiler BootProfile;
+
+BootProfiler::BootProfiler() : last(0) { memset(durations, 0, sizeof(durations)); }
+
+void BootProfiler::begin()
+{
+    last = 0;
+    this->mark(BOOT_RESET);
+}
+
+void BootProfiler::mark(BootPhase phase)
+{
+    uint32_t now = micros();
+    durations[phase] = now - last;
+    last = now;
+}
+
+void BootProfiler::report() const
+{
+    char num[11];
+    uint32_t total = 0;
+
+    MsgService.sendMsgRaw(F("{\"" BOOT_KEY "\":{"), false);
+    for (uint8_t i = 0; i < BOOT_PHASES; i++)
+    {
+        MsgService.sendMsgRaw((const __FlashStringHelper*)pgm_read_ptr(&BOOT_NAMES[i]), false);
+        MsgService.sendMsgRaw(ultoa(durations[i], num, 10), false);
+        total += durations[i];
+    }
+    MsgService.sendMsgRaw(F(",\"total\":"), false);
+    MsgService.sendMsgRaw(ultoa(total, num, 10), false);
+    MsgService.sendMsgRaw(F("}}"), true);
+}
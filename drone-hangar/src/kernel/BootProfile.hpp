@@ -0,0 +1,53 @@
+#ifndef __BOOT_PROFILE__
+#define __BOOT_PROFILE__
+
+#include <Arduino.h>
+
+/**
+ * @brief Phases of setup(), in the order they run.
+ */
+enum BootPhase : uint8_t
+{
+    BOOT_RESET,   /**< From reset to the start of setup() (core init) */
+    BOOT_SERIAL,  /**< MsgService and scheduler timer */
+    BOOT_STORAGE, /**< Parameters and journal from the EEPROM */
+    BOOT_DEVICES, /**< Pins of LEDs, button, sensors */
+    BOOT_LCD,     /**< LCD I2C init */
+    BOOT_SERVO,   /**< Servo attach */
+    BOOT_PIR,     /**< Start of the PIR warm-up (it goes on in background) */
+    BOOT_TASKS,   /**< Context and tasks */
+    BOOT_PHASES
+};
+
+/**
+ * @brief Duration of each setup() phase, reported once over serial as
+ * {"boot":{"reset":us,"serial":us,...,"total":us}}.
+ */
+class BootProfiler
+{
+   private:
+    uint32_t durations[BOOT_PHASES]; /**< us */
+    uint32_t last;                   /**< micros() at the end of the previous phase */
+
+   public:
+    BootProfiler();
+
+    /**
+     * @brief Call first thing in setup().
+     */
+    void begin();
+
+    /**
+     * @brief End a phase: it lasted since the previous mark.
+     */
+    void mark(BootPhase phase);
+
+    /**
+     * @brief Send the profile as one JSON line (the protocol is always JSON at boot).
+     */
+    void report() const;
+};
+
+extern BootProfiler BootProfile;
+
+#endif
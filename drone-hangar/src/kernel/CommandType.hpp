@@ -1,13 +1,37 @@
 #ifndef __COMMAND_TYPE__
 #define __COMMAND_TYPE__
 
+/*
+ * Every command accepted from the remote unit: X(type, name), where name is
+ * the value of the "cmd" key (defined in config.hpp).
+ *
+ * The position in the list is also the command code used by the binary
+ * protocol, so new commands must be appended at the end. The names are
+ * looked up through a compile-time perfect hash (see Context.cpp).
+ */
+#define COMMAND_CATALOG(X)     \
+    X(OPEN, OPEN_CMD)          \
+    X(DUMP_LOG, DUMP_CMD)      \
+    X(RESET_ALARM, RESET_CMD)  \
+    X(STATS, STATS_CMD)        \
+    X(JOURNAL, JOURNAL_CMD)
+
+#define COMMAND_TYPE_ENUM(type, name) type,
+
 /**
  * @brief Semantic commands decoded from incoming messages.
+ *
+ * OPEN opens the hangar door, DUMP_LOG dumps the log ring (post-mortem),
+ * RESET_ALARM acts as the reset button, STATS reports the internal counters,
+ * JOURNAL streams the EEPROM journal.
  */
 enum class CommandType
 {
-    /// @brief Command to open the hangar door
-    OPEN
+    COMMAND_CATALOG(COMMAND_TYPE_ENUM)
+    /// @brief Number of commands, not a command
+    COUNT
 };
 
+#undef COMMAND_TYPE_ENUM
+
 #endif
@@ -0,0 +1,39 @@
+#include "kernel/InputEvents.hpp"
+
+// Keeps the compiler from moving the slot access across the index update
+#define COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "INPUT_QUEUE_SIZE must be a power of two");
+
+InputEventQueue InputEvents;
+
+InputEventQueue::InputEventQueue() : head(0), tail(0), dropped(0) {}
+
+bool InputEventQueue::push(InputEventType type, unsigned long time)
+{
+    uint8_t next = (head + 1) & (INPUT_QUEUE_SIZE - 1);
+    if (next == tail)
+    {
+        if (dropped < 0xFF)
+            dropped++;
+        return false;
+    }
+    events[head].type = type;
+    events[head].time = time;
+    COMPILER_BARRIER();
+    head = next;  // publish after the slot is written
+    return true;
+}
+
+bool InputEventQueue::pop(InputEvent& event)
+{
+    if (tail == head)
+        return false;
+    COMPILER_BARRIER();
+    event = events[tail];
+    COMPILER_BARRIER();
+    tail = (tail + 1) & (INPUT_QUEUE_SIZE - 1);
+    return true;
+}
+
+uint8_t InputEventQueue::getDropped() const { return dropped; }
@@ -0,0 +1,75 @@
+#ifndef __INPUT_EVENTS__
+#define __INPUT_EVENTS__
+
+#include <Arduino.h>
+
+/*
+ * Edges of the interrupt-driven inputs, timestamped by the ISR that saw
+ * them and consumed by AcquisitionTask.
+ *
+ * The queue is single producer / single consumer without locks: only the
+ * ISRs push (they do not nest, so they act as one producer) and only the
+ * main loop pops. Each side owns one index, and a uint8_t is read and
+ * written atomically on AVR.
+ */
+
+/** @brief Queue length, a power of two. */
+#define INPUT_QUEUE_SIZE 8
+
+/**
+ * @brief Kind of input edge.
+ */
+enum InputEventType : uint8_t
+{
+    INPUT_PIR_RISE,    /**< Presence detected */
+    INPUT_PIR_FALL,    /**< Presence lost */
+    INPUT_BUTTON_DOWN, /**< Debounced press */
+    INPUT_BUTTON_UP    /**< Debounced release */
+};
+
+/**
+ * @brief One edge and the millis() it happened at.
+ */
+struct InputEvent
+{
+    InputEventType type;
+    unsigned long time;
+};
+
+/**
+ * @brief Lock-free queue of input edges from the ISRs.
+ */
+class InputEventQueue
+{
+   private:
+    InputEvent events[INPUT_QUEUE_SIZE];
+    volatile uint8_t head; /**< Written by the producer only */
+    volatile uint8_t tail; /**< Written by the consumer only */
+    volatile uint8_t dropped;
+
+   public:
+    InputEventQueue();
+
+    /**
+     * @brief Queue an edge. ISR side only.
+     *
+     * @return false if the queue is full (the edge is counted as dropped).
+     */
+    bool push(InputEventType type, unsigned long time);
+
+    /**
+     * @brief Take the oldest edge. Main loop only.
+     *
+     * @return false if the queue is empty.
+     */
+    bool pop(InputEvent& event);
+
+    /**
+     * @brief Edges lost because the queue was full.
+     */
+    uint8_t getDropped() const;
+};
+
+extern InputEventQueue InputEvents;
+
+#endif
@@ -0,0 +1,165 @@
+#include "Journal.hpp"
+
+#include <EEPROM.h>
+#include <avr/eeprom.h>
+
+#define JOURNAL_MAGIC 0x4A
+#define JOURNAL_RECORDS_ADDR (JOURNAL_EEPROM_ADDR + 2)
+#define JOURNAL_SEQ_BYTE 0
+#define JOURNAL_SUBSYSTEM_BYTE 3
+#define JOURNAL_FORMAT_SIZE (2 * JOURNAL_CAPACITY + 2)
+#define JOURNAL_FORMATTED 0xFFFF
+
+static_assert(JOURNAL_CAPACITY < 256, "the sequence break is only unique with less than 256 slots");
+static_assert(JOURNAL_CAPACITY > 0, "no EEPROM left for the journal");
+
+JournalService Journal;
+
+JournalService::JournalService()
+    : pendingHead(0),
+      pendingCount(0),
+      dropped(0),
+      byteIndex(0),
+      slot(0),
+      seq(0),
+      formatIndex(JOURNAL_FORMATTED),
+      lastTime(0)
+{
+}
+
+uint16_t JournalService::slotAddr(uint16_t s) const { return JOURNAL_RECORDS_ADDR + s * JOURNAL_RECORD_SIZE; }
+
+uint8_t JournalService::recordByte(const Record& r, uint8_t i) const
+{
+    switch (i)
+    {
+        case JOURNAL_SEQ_BYTE:
+            return seq;
+        case 1:
+            return (uint8_t)r.delta;
+        case 2:
+            return (uint8_t)(r.delta >> 8);
+        case JOURNAL_SUBSYSTEM_BYTE:
+            return r.subsystem;
+        default:
+            return r.states;
+    }
+}
+
+void JournalService::formatStep()
+{
+    // Consecutive sequence numbers with a single break after the last slot,
+    // then the header: a format cut by a reset starts over on the next boot
+    uint16_t s = formatIndex / 2;
+    if (formatIndex >= 2 * JOURNAL_CAPACITY)
+        EEPROM.update(JOURNAL_EEPROM_ADDR + formatIndex - 2 * JOURNAL_CAPACITY,
+                      formatIndex == 2 * JOURNAL_CAPACITY ? JOURNAL_MAGIC : JOURNAL_VERSION);
+    else if (formatIndex % 2 == 0)
+        EEPROM.update(slotAddr(s) + JOURNAL_SEQ_BYTE, (uint8_t)s);
+    else
+        EEPROM.update(slotAddr(s) + JOURNAL_SUBSYSTEM_BYTE, JOURNAL_EMPTY);
+
+    if (++formatIndex == JOURNAL_FORMAT_SIZE)
+        formatIndex = JOURNAL_FORMATTED;
+}
+
+void JournalService::init()
+{
+    lastTime = 0;
+    if (EEPROM.read(JOURNAL_EEPROM_ADDR) != JOURNAL_MAGIC || EEPROM.read(JOURNAL_EEPROM_ADDR + 1) != JOURNAL_VERSION)
+    {
+        // Where the ring starts once formatted; the first boot does not wait ~1.3 s for it
+        formatIndex = 0;
+        slot = 0;
+        seq = (uint8_t)JOURNAL_CAPACITY;
+        record(JOURNAL_BOOT, 0, 0);
+        return;
+    }
+
+    uint8_t prev = EEPROM.read(slotAddr(0) + JOURNAL_SEQ_BYTE);
+    slot = 0;
+    seq = prev + 1;
+    for (uint16_t s = 1; s <= JOURNAL_CAPACITY; s++)
+    {
+        uint8_t cur = EEPROM.read(slotAddr(s % JOURNAL_CAPACITY) + JOURNAL_SEQ_BYTE);
+        if (cur != (uint8_t)(prev + 1))
+        {
+            slot = s % JOURNAL_CAPACITY;
+            seq = prev + 1;
+            break;
+        }
+        prev = cur;
+    }
+
+    record(JOURNAL_BOOT, 0, 0);
+}
+
+void JournalService::record(JournalSubsystem subsystem, uint8_t oldState, uint8_t newState)
+{
+    if (pendingCount >= JOURNAL_RAM_SIZE)
+    {
+        if (dropped < 0xFF)
+            dropped++;
+        return;
+    }
+
+    unsigned long now = millis();
+    unsigned long delta = now - lastTime;
+    lastTime = now;
+
+    Record& r = pending[(pendingHead + pendingCount) % JOURNAL_RAM_SIZE];
+    r.delta = delta > 0xFFFF ? 0xFFFF : (uint16_t)delta;
+    r.subsystem = subsystem;
+    r.states = (uint8_t)((oldState << 4) | (newState & 0x0F));
+    pendingCount++;
+}
+
+void JournalService::flush()
+{
+    if (!eeprom_is_ready())
+        return;
+    if (formatIndex != JOURNAL_FORMATTED)
+    {
+        formatStep();
+        return;
+    }
+    if (pendingCount == 0)
+        return;
+
+    // Payload first, sequence byte last
+    uint8_t i = (byteIndex + 1) % JOURNAL_RECORD_SIZE;
+    EEPROM.update(slotAddr(slot) + i, recordByte(pending[pendingHead], i));
+
+    if (++byteIndex < JOURNAL_RECORD_SIZE)
+        return;
+
+    byteIndex = 0;
+    slot = (slot + 1) % JOURNAL_CAPACITY;
+    seq++;
+    pendingHead = (pendingHead + 1) % JOURNAL_RAM_SIZE;
+    pendingCount--;
+}
+
+uint16_t JournalService::size() const { return JOURNAL_CAPACITY; }
+
+JournalMark JournalService::mark() const { return {slot, seq}; }
+
+bool JournalService::read(const JournalMark& at, uint16_t index, uint16_t& delta, uint8_t& subsystem,
+                          uint8_t& states) const
+{
+    uint16_t s = (at.slot + index) % JOURNAL_CAPACITY;
+    if (formatIndex != JOURNAL_FORMATTED || (s == slot && byteIndex > 0))
+        return false;
+
+    // Written at most JOURNAL_CAPACITY records before the mark, else rewritten since
+    uint16_t addr = slotAddr(s);
+    uint8_t age = at.seq - EEPROM.read(addr + JOURNAL_SEQ_BYTE);
+    subsystem = EEPROM.read(addr + JOURNAL_SUBSYSTEM_BYTE);
+    if (age == 0 || age > JOURNAL_CAPACITY || subsystem == JOURNAL_EMPTY)
+        return false;
+    delta = EEPROM.read(addr + 1) | ((uint16_t)EEPROM.read(addr + 2) << 8);
+    states = EEPROM.read(addr + 4);
+    return true;
+}
+
+uint8_t JournalService::getDropped() const { return dropped; }
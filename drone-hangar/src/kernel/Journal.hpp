@@ -0,0 +1,143 @@
+#ifndef __JOURNAL__
+#define __JOURNAL__
+
+#include <Arduino.h>
+
+/*
+ * Persistent journal of state transitions in the EEPROM, after the
+ * parameter block.
+ *
+ * The region is a ring of fixed size records written strictly in order, so
+ * every cell is rewritten once per JOURNAL_CAPACITY records (wear leveling
+ * by construction). Each record is:
+ *
+ *   [seq:u8][delta:u16][subsystem:u8][old:4 | new:4]
+ *
+ * seq grows by one per record; the newest record is the one followed by a
+ * break in the sequence, so no separate head pointer has to be rewritten.
+ * delta is the time since the previous record in ms (saturated), and the
+ * BOOT record marks a reset. seq is written last: a record cut by a reset
+ * never looks like the newest one.
+ */
+
+/** @brief First EEPROM address of the journal (the parameter block is below). */
+#define JOURNAL_EEPROM_ADDR 64
+
+/** @brief Size of a record in EEPROM. */
+#define JOURNAL_RECORD_SIZE 5
+
+/** @brief Number of records in the EEPROM ring. */
+#define JOURNAL_CAPACITY ((E2END + 1 - JOURNAL_EEPROM_ADDR - 2) / JOURNAL_RECORD_SIZE)
+
+/** @brief Records waiting in RAM to be written. */
+#define JOURNAL_RAM_SIZE 8
+
+/** @brief Change it to reformat the journal region on the next boot. */
+#define JOURNAL_VERSION 1
+
+/**
+ * @brief Origin of a journal record.
+ */
+enum JournalSubsystem : uint8_t
+{
+    JOURNAL_BOOT,
+    JOURNAL_DRONE,
+    JOURNAL_HANGAR,
+    JOURNAL_DOOR,
+    JOURNAL_DISTANCE,
+    JOURNAL_EMPTY = 0xFF /**< Slot never written since the last format */
+};
+
+/**
+ * @brief Position of the ring when an export started, see JournalService::mark().
+ */
+struct JournalMark
+{
+    uint16_t slot; /**< Oldest slot */
+    uint8_t seq;   /**< Sequence number of the next record */
+};
+
+/**
+ * @brief Wear-leveled EEPROM journal with batched, non-blocking writes.
+ */
+class JournalService
+{
+   private:
+    struct Record
+    {
+        uint16_t delta;
+        uint8_t subsystem;
+        uint8_t states;
+    };
+
+    Record pending[JOURNAL_RAM_SIZE];
+    uint8_t pendingHead;
+    uint8_t pendingCount;
+    uint8_t dropped;        /**< Records lost because the RAM queue was full */
+    uint8_t byteIndex;      /**< Next byte of the record being written */
+    uint16_t slot;          /**< EEPROM slot of the next record */
+    uint8_t seq;            /**< Sequence number of the next record */
+    uint16_t formatIndex;   /**< Next byte of the format, JOURNAL_FORMATTED when done */
+    unsigned long lastTime; /**< millis() of the previous record */
+
+    uint16_t slotAddr(uint16_t s) const;
+    uint8_t recordByte(const Record& r, uint8_t i) const;
+    void formatStep();
+
+   public:
+    JournalService();
+
+    /**
+     * @brief Find the head of the ring and record a BOOT entry.
+     *
+     * A region that needs a format is formatted by flush(), a byte at a
+     * time, before the first record is written; it reads as empty until then.
+     */
+    void init();
+
+    /**
+     * @brief Queue a transition in RAM, O(1). Nothing is written here.
+     *
+     * @param subsystem The subsystem changing state.
+     * @param oldState The state it leaves (0-15).
+     * @param newState The state it enters (0-15).
+     */
+    void record(JournalSubsystem subsystem, uint8_t oldState, uint8_t newState);
+
+    /**
+     * @brief Write at most one byte (format or record) if the EEPROM is idle.
+     *
+     * Meant as a Scheduler background step: an EEPROM byte takes ~3.3 ms,
+     * so the write is only started, never waited for.
+     */
+    void flush();
+
+    /**
+     * @brief Number of slots readable with read(), written or not.
+     */
+    uint16_t size() const;
+
+    /**
+     * @brief Current position of the ring, to read it while it moves on.
+     */
+    JournalMark mark() const;
+
+    /**
+     * @brief Read a record, 0 being the oldest one at the mark.
+     *
+     * A slot rewritten since the mark, or being written, reads as empty:
+     * an export never mixes records from before and after its start.
+     *
+     * @return true if the slot holds a record older than the mark.
+     */
+    bool read(const JournalMark& at, uint16_t index, uint16_t& delta, uint8_t& subsystem, uint8_t& states) const;
+
+    /**
+     * @brief Records lost because the RAM queue was full.
+     */
+    uint8_t getDropped() const;
+};
+
+extern JournalService Journal;
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef __LOG_CATALOG__
+#define __LOG_CATALOG__
+
+#include <stdint.h>
+
+/*
+ * Dictionary of every fixed log message.
+ *
+ * Each entry gets a compile-time LogId. When the firmware is built with
+ * LOG_DICTIONARY defined only the id (and the optional integer argument)
+ * goes on the wire and the texts are not linked at all; the host-side
+ * decoder (tools/logdecode.cpp) includes this same header to expand them.
+ *
+ * Append new entries at the end: ids must stay stable between the firmware
+ * and the decoder. The optional argument is printed after the text.
+ *
+ * Each entry belongs to a module and has a level; the Logger drops it with a
+ * single byte test when the module's runtime level is lower.
+ */
+#define LOG_CATALOG(X)                                                                  \
+    X(HANGAR_READY, SYS, INFO, ":::::: Drone Hangar Ready ::::::")                      \
+    X(HW_TEST_MODE, SYS, INFO, ":::::: Hardware Testing Mode ::::::")                   \
+    X(PIR_CALIBRATING, SYS, INFO, "Calibrating PIR...")                                 \
+    X(DRONE_REST, DRONE, INFO, "[Drone] REST")                                          \
+    X(DRONE_TAKING_OFF, DRONE, INFO, "[Drone] TAKING OFF")                              \
+    X(DRONE_OPERATING, DRONE, INFO, "[Drone] OPERATING")                                \
+    X(DRONE_LANDING, DRONE, INFO, "[Drone] LANDING")                                    \
+    X(DOOR_CLOSED, DOOR, INFO, "[DOOR] CLOSED")                                         \
+    X(DOOR_OPENING, DOOR, INFO, "[DOOR] OPENING")                                       \
+    X(DOOR_OPEN, DOOR, INFO, "[DOOR] OPEN")                                             \
+    X(DOOR_CLOSING, DOOR, INFO, "[DOOR] CLOSING")                                       \
+    X(HT_NORMAL, HT, INFO, "[HT] NORMAL")                                               \
+    X(HT_TRACKING_PRE_ALARM, HT, INFO, "[HT] TRACKING PRE-ALARM")                       \
+    X(HT_PREALARM, HT, INFO, "[HT] PREALARM ACTIVE")                                    \
+    X(HT_TRACKING_ALARM, HT, INFO, "[HT] TRACKING ALARM")                               \
+    X(HT_ALARM, HT, INFO, "[HT] ALARM")                                                 \
+    X(DISTANCE_IDLE, DISTANCE, INFO, "[DISTANCE] IDLE")                                 \
+    X(DISTANCE_LANDING_MONITORING, DISTANCE, INFO, "[DISTANCE] LANDING MONITORING")     \
+    X(DISTANCE_LANDING_WAITING, DISTANCE, INFO, "[DISTANCE] LANDING WAITING")           \
+    X(DISTANCE_TAKEOFF_MONITORING, DISTANCE, INFO, "[DISTANCE] TAKEOFF MONITORING")     \
+    X(DISTANCE_TAKEOFF_WAITING, DISTANCE, INFO, "[DISTANCE] TAKEOFF WAITING")           \
+    X(MSG_OVR, MSG, WARN, "MSG_OVR")                                                    \
+    X(JSON_ERR, MSG, WARN, "JSON_ERR")                                                  \
+    X(JSON_OVR, MSG, WARN, "JSON_OVR")                                                  \
+    X(CMD_OK, MSG, INFO, "CMD_OK")                                                      \
+    X(CMD_ERR, MSG, WARN, "CMD_ERR")                                                    \
+    X(CMD_NULL, MSG, WARN, "CMD_NULL")                                                  \
+    X(PROTO_ERR, MSG, WARN, "PROTO_ERR")                                                \
+    X(FRAME_ERR, MSG, WARN, "FRAME_ERR")                                                \
+    X(LOST, LOG, WARN, "[LOG] LOST")                                                    \
+    X(DUMP, LOG, INFO, "[LOG] DUMP")                                                    \
+    X(SUPPRESSED, LOG, INFO, "[LOG] SUPPRESSED")                                        \
+    X(CMD_LATENCY, MSG, DEBUG, "[CMD] LATENCY MS")                                      \
+    X(PIR_READY, SYS, INFO, "PIR ready")                                                \
+    X(LCD_I2C_BYTES, SYS, DEBUG, "[LCD] I2C BYTES")                                     \
+    X(LCD_UPDATE_US, SYS, DEBUG, "[LCD] UPDATE US")                                     \
+    X(LCD_LATENCY_MS, SYS, DEBUG, "[LCD] LATENCY MS")
+
+#define LOG_ID_ENUM(id, module, level, text) LOG_##id,
+
+/**
+ * @brief Identifier of a catalog log message.
+ */
+enum LogId : uint8_t
+{
+    LOG_CATALOG(LOG_ID_ENUM) LOG_COUNT
+};
+
+#undef LOG_ID_ENUM
+
+/**
+ * @brief Modules a catalog message can belong to (at most 8).
+ */
+enum LogModule : uint8_t
+{
+    LOG_MODULE_SYS,
+    LOG_MODULE_DRONE,
+    LOG_MODULE_DOOR,
+    LOG_MODULE_DISTANCE,
+    LOG_MODULE_HT,
+    LOG_MODULE_MSG,
+    LOG_MODULE_LOG,
+    LOG_MODULE_COUNT
+};
+
+/**
+ * @brief Severity of a catalog message, most severe first.
+ *
+ * A module set to level L emits the messages whose level is <= L.
+ * LOG_LEVEL_OFF is only used as a module level, to silence it.
+ */
+enum LogLevel : uint8_t
+{
+    LOG_LEVEL_OFF,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_COUNT
+};
+
+#define LOG_META_ENTRY(id, module, level, text) \
+    (uint8_t)(LOG_MODULE_##module | (LOG_LEVEL_##level << 4)),
+
+/**
+ * @brief Module (low nibble) and level (high nibble) of every entry.
+ *
+ * Only indexed with constant ids from inline code, so it folds away.
+ */
+static constexpr uint8_t LOG_META[LOG_COUNT] = {LOG_CATALOG(LOG_META_ENTRY)};
+
+#undef LOG_META_ENTRY
+
+#endif
@@ -1,15 +1,275 @@
 #include "Logger.hpp"
 
 #include "MsgService.hpp"
+#include "kernel/BinaryProtocol.hpp"
+
+#define LOG_ARG_FLAG 0x80
+
+#ifndef LOG_DICTIONARY
+#define LOG_TEXT_DEF(id, module, level, text) static const char LOG_TEXT_##id[] PROGMEM = text;
+#define LOG_TEXT_REF(id, module, level, text) LOG_TEXT_##id,
+LOG_CATALOG(LOG_TEXT_DEF)
+static const char* const LOG_TEXTS[] PROGMEM = {LOG_CATALOG(LOG_TEXT_REF)};
+#undef LOG_TEXT_DEF
+#undef LOG_TEXT_REF
+#endif
+
+static const char MODULE_SYS[] PROGMEM = "SYS";
+static const char MODULE_DRONE[] PROGMEM = "DRONE";
+static const char MODULE_DOOR[] PROGMEM = "DOOR";
+static const char MODULE_DISTANCE[] PROGMEM = "DISTANCE";
+static const char MODULE_HT[] PROGMEM = "HT";
+static const char MODULE_MSG[] PROGMEM = "MSG";
+static const char MODULE_LOG[] PROGMEM = "LOG";
+static const char* const MODULE_NAMES[LOG_MODULE_COUNT] PROGMEM = {
+    MODULE_SYS, MODULE_DRONE, MODULE_DOOR, MODULE_DISTANCE, MODULE_HT, MODULE_MSG, MODULE_LOG};
+
+LoggerService Logger;
+
+LoggerService::LoggerService()
+{
+    for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++)
+    {
+        setLevel((LogModule)m, LOG_DEFAULT_LEVEL);
+    }
+}
+
+static void sendLogFrame(const char* text)
+{
+    uint8_t frame[FRAME_MAX_SIZE];
+    FrameWriter writer(frame, sizeof(frame), FRAME_LOG, MsgService.nextSeq());
+    writer.putBytes(FIELD_TEXT, (const uint8_t*)text, (uint8_t)strnlen(text, FRAME_MAX_SIZE));
+    MsgService.sendFrame(frame, writer.finish());
+}
 
 void LoggerService::log(const String& msg)
 {
+    if (MsgService.isBinaryMode())
+    {
+        sendLogFrame(msg.c_str());
+        return;
+    }
     MsgService.sendMsgRaw("lo:", false);
     MsgService.sendMsgRaw(msg.c_str(), true);
 }
 
 void LoggerService::log(const __FlashStringHelper* msg)
 {
+    if (MsgService.isBinaryMode())
+    {
+        char text[FRAME_MAX_SIZE];
+        strncpy_P(text, (PGM_P)msg, sizeof(text) - 1);
+        text[sizeof(text) - 1] = '\0';
+        sendLogFrame(text);
+        return;
+    }
     MsgService.sendMsgRaw("lo:", false);
     MsgService.sendMsgRaw(msg, true);
 }
+
+bool LoggerService::setLevel(LogModule module, uint8_t level)
+{
+    if (module >= LOG_MODULE_COUNT || level >= LOG_LEVEL_COUNT)
+        return false;
+    for (uint8_t l = 0; l < LOG_LEVEL_COUNT; l++)
+    {
+        if (l != LOG_LEVEL_OFF && l <= level)
+            levelMask[l] |= (uint8_t)(1 << module);
+        else
+            levelMask[l] &= (uint8_t) ~(1 << module);
+    }
+    return true;
+}
+
+LogModule LoggerService::moduleFromName(const char* name) const
+{
+    for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++)
+    {
+        if (strcasecmp_P(name, (PGM_P)pgm_read_ptr(&MODULE_NAMES[m])) == 0)
+            return (LogModule)m;
+    }
+    return LOG_MODULE_COUNT;
+}
+
+bool LoggerService::isRepeat(uint8_t id, int16_t arg)
+{
+    // Stops on the match, else on the least recently used slot
+    uint8_t i = 0;
+    while (i < LOG_RATE_SLOTS - 1 && !(recent[i].time != 0 && recent[i].id == id && recent[i].arg == arg))
+        i++;
+
+    RateSlot slot = recent[i];
+    uint16_t now = (uint16_t)millis();
+    bool repeat = slot.time != 0 && slot.id == id && slot.arg == arg &&
+                  (uint16_t)(now - slot.time) < LOG_RATE_WINDOW_MS;
+    if (!repeat)
+    {
+        slot.id = id;
+        slot.arg = arg;
+        slot.time = now ? now : 1;  // 0 means free
+    }
+    memmove(&recent[1], &recent[0], i * sizeof(RateSlot));
+    recent[0] = slot;
+    return repeat;
+}
+
+void LoggerService::push(LogId id, bool hasArg, int16_t arg)
+{
+    if (id >= LOG_COUNT)
+        return;
+
+    uint8_t key = hasArg ? (uint8_t)(id | LOG_ARG_FLAG) : (uint8_t)id;
+    if (!logRateExempt(id) && isRepeat(key, arg))
+    {
+        if (suppressed < 0x7FFF)
+            suppressed++;
+        return;
+    }
+
+    LogEntry& entry = ring[head];
+    entry.time = millis();
+    entry.id = key;
+    entry.arg = arg;
+
+    if (dumpLeft > 0 && dumpNext == head)
+    {
+        // The entry waiting to be dumped is gone
+        dumpNext = (dumpNext + 1) % LOG_RING_SIZE;
+        dumpLeft--;
+    }
+    head = (head + 1) % LOG_RING_SIZE;
+    if (count < LOG_RING_SIZE)
+        count++;
+    if (pending < LOG_RING_SIZE)
+        pending++;
+    else
+        lost++;  // overwrite oldest: the undrained entry at head is gone
+}
+
+void LoggerService::drain()
+{
+    uint16_t now = (uint16_t)millis();
+    if (suppressed > 0 && (uint16_t)(now - suppressedReportedAt) >= LOG_RATE_WINDOW_MS)
+    {
+        // LOG_SUPPRESSED is not rate limited itself
+        push(LOG_SUPPRESSED, true, (int16_t)suppressed);
+        suppressed = 0;
+        suppressedReportedAt = now;
+    }
+
+    while (pending > 0 && Serial.availableForWrite() >= LOG_DRAIN_MIN_TX_FREE)
+    {
+        uint8_t index = (head + LOG_RING_SIZE - pending) % LOG_RING_SIZE;
+        emit(ring[index], false);
+        pending--;
+    }
+
+    if (lost != lostReported && Serial.availableForWrite() >= LOG_DRAIN_MIN_TX_FREE)
+    {
+        LogEntry entry = {(uint32_t)millis(), (uint8_t)(LOG_LOST | LOG_ARG_FLAG),
+                          (int16_t)(lost - lostReported)};
+        lostReported = lost;
+        emit(entry, false);
+    }
+
+    // A dump only goes out once the live entries are sent
+    while (pending == 0 && dumpStage != LOG_DUMP_IDLE && Serial.availableForWrite() >= LOG_DRAIN_MIN_TX_FREE)
+    {
+        dumpStep();
+    }
+}
+
+void LoggerService::startDump()
+{
+    if (dumpStage != LOG_DUMP_IDLE)
+        return;
+    dumpNext = (head + LOG_RING_SIZE - count) % LOG_RING_SIZE;
+    dumpLeft = count;
+    dumpStage = LOG_DUMP_HEADER;
+}
+
+void LoggerService::dumpStep()
+{
+    LogEntry entry = {(uint32_t)millis(), 0, 0};
+    switch (dumpStage)
+    {
+        case LOG_DUMP_HEADER:
+            entry.id = (uint8_t)(LOG_DUMP | LOG_ARG_FLAG);
+            entry.arg = (int16_t)dumpLeft;
+            emit(entry, false);
+            dumpStage = LOG_DUMP_ENTRIES;
+            break;
+
+        case LOG_DUMP_ENTRIES:
+            if (dumpLeft > 0)
+            {
+                entry = ring[dumpNext];
+                dumpNext = (dumpNext + 1) % LOG_RING_SIZE;
+                dumpLeft--;
+                emit(entry, true);
+            }
+            else
+            {
+                dumpStage = LOG_DUMP_FOOTER;
+            }
+            break;
+
+        case LOG_DUMP_FOOTER:
+            entry.id = (uint8_t)(LOG_LOST | LOG_ARG_FLAG);
+            entry.arg = (int16_t)lost;
+            emit(entry, false);
+            dumpStage = LOG_DUMP_IDLE;
+            break;
+    }
+}
+
+uint16_t LoggerService::getLostCount() const { return lost; }
+
+void LoggerService::emit(const LogEntry& entry, bool withTime)
+{
+    uint8_t id = entry.id & ~LOG_ARG_FLAG;
+    bool hasArg = (entry.id & LOG_ARG_FLAG) != 0;
+
+    if (MsgService.isBinaryMode())
+    {
+        // Ids only: the host expands them with the same catalog
+        uint8_t frame[FRAME_MAX_SIZE];
+        FrameWriter writer(frame, sizeof(frame), FRAME_LOG, MsgService.nextSeq());
+        writer.putU8(FIELD_LOG_ID, id);
+        if (hasArg)
+            writer.putI16(FIELD_LOG_ARG, entry.arg);
+        if (withTime)
+            writer.putU32(FIELD_TIMESTAMP, entry.time);
+        MsgService.sendFrame(frame, writer.finish());
+        return;
+    }
+
+    char num[12];
+#ifdef LOG_DICTIONARY
+    MsgService.sendMsgRaw("ld:", false);
+    itoa(id, num, 10);
+    MsgService.sendMsgRaw(num, false);
+    if (hasArg)
+    {
+        MsgService.sendMsgRaw(",", false);
+        itoa(entry.arg, num, 10);
+        MsgService.sendMsgRaw(num, false);
+    }
+#else
+    MsgService.sendMsgRaw("lo:", false);
+    MsgService.sendMsgRaw((const __FlashStringHelper*)pgm_read_ptr(&LOG_TEXTS[id]), false);
+    if (hasArg)
+    {
+        MsgService.sendMsgRaw(" ", false);
+        itoa(entry.arg, num, 10);
+        MsgService.sendMsgRaw(num, false);
+    }
+#endif
+    if (withTime)
+    {
+        MsgService.sendMsgRaw(" @", false);
+        ultoa(entry.time, num, 10);
+        MsgService.sendMsgRaw(num, false);
+    }
+    MsgService.sendMsgRaw("", true);
+}
@@ -2,14 +2,112 @@
 #define __LOGGER__
 
 #include "Arduino.h"
+#include "kernel/LogCatalog.hpp"
+
+/** @brief Number of catalog entries kept in RAM (7 bytes each). */
+#define LOG_RING_SIZE 16
+
+/** @brief Free bytes required in the serial TX buffer before draining an entry. */
+#define LOG_DRAIN_MIN_TX_FREE 40
+
+/** @brief A message repeated with the same argument within this window (ms) is suppressed. */
+#define LOG_RATE_WINDOW_MS 2000
+
+/** @brief Last emitted (message, argument) pairs remembered by the rate limiter (5 bytes each). */
+#define LOG_RATE_SLOTS 4
+
+/*
+ * Never rate limited: the acks (CMD_OK and CMD_ERR) answer a request the
+ * peer waits for, and SUPPRESSED is the report of the repeats itself.
+ */
+#define LOG_RATE_EXEMPT(X) \
+    X(CMD_OK)              \
+    X(CMD_ERR)             \
+    X(SUPPRESSED)
+
+#define LOG_RATE_CASE(name) id == LOG_##name ||
+
+/** @brief true if a message is never rate limited. */
+constexpr bool logRateExempt(LogId id) { return LOG_RATE_EXEMPT(LOG_RATE_CASE) false; }
+
+#undef LOG_RATE_CASE
+
+/** @brief Stages of a dump streamed by drain(). */
+#define LOG_DUMP_IDLE 0
+#define LOG_DUMP_HEADER 1
+#define LOG_DUMP_ENTRIES 2
+#define LOG_DUMP_FOOTER 3
+
+/** @brief Level every module starts with (the LCD and command timings are DEBUG). */
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
 
 /**
  * @brief Service for logging messages.
  *
+ * Catalog messages are not written to Serial by log(): they are stored in a
+ * RAM ring in O(1) and sent later by drain(), which the scheduler runs while
+ * waiting for the next slot. When the ring is full the oldest entry is
+ * overwritten; entries overwritten before being sent are counted and reported
+ * with a LOG_LOST entry. The last LOG_RING_SIZE entries stay in the ring and
+ * can be sent again, with their timestamp, after startDump(); drain() streams
+ * them behind the pending entries, under the same TX room check.
+ *
+ * Each module has a runtime level. The test is inlined at the call site and,
+ * since the id is a constant, reduces to one bit test on a mask byte. A
+ * message repeated with the same argument within LOG_RATE_WINDOW_MS of its
+ * last emission is dropped and counted; drain() reports the count as
+ * "[LOG] SUPPRESSED <n>" at most once per window. The last LOG_RATE_SLOTS
+ * (message, argument) pairs are kept in least recently used order.
  */
 class LoggerService
 {
+   private:
+    struct LogEntry
+    {
+        uint32_t time;
+        uint8_t id; /**< LogId, bit 7 set if arg is valid */
+        int16_t arg;
+    };
+
+    struct RateSlot
+    {
+        uint8_t id; /**< LogId and arg flag, as in LogEntry */
+        int16_t arg;
+        uint16_t time; /**< Low 16 bits of millis() of the last emission, 0 if free */
+    };
+
+    LogEntry ring[LOG_RING_SIZE];
+    uint8_t head;    /**< Next slot to write */
+    uint8_t count;   /**< Entries retained for a dump */
+    uint8_t pending; /**< Entries not yet drained */
+    uint16_t lost;   /**< Entries overwritten before being drained */
+    uint16_t lostReported;
+    uint8_t dumpNext;   /**< Ring index of the next entry to dump */
+    uint8_t dumpLeft;   /**< Entries still to dump */
+    uint8_t dumpStage;  /**< LOG_DUMP_IDLE, _HEADER, _ENTRIES or _FOOTER */
+
+    uint8_t levelMask[LOG_LEVEL_COUNT];    /**< Bit m set if module m emits the level */
+    RateSlot recent[LOG_RATE_SLOTS];       /**< Last emissions, most recently used first */
+    uint16_t suppressed;                   /**< Repeats dropped since the last report */
+    uint16_t suppressedReportedAt;         /**< Low 16 bits of millis() of the last report */
+
+    bool isEnabled(LogId id) const
+    {
+        return levelMask[LOG_META[id] >> 4] & (1 << (LOG_META[id] & 0x0F));
+    }
+
+    /** true if the entry repeats one emitted within the window; either way it becomes the most recent. */
+    bool isRepeat(uint8_t id, int16_t arg);
+
+    void push(LogId id, bool hasArg, int16_t arg);
+    void emit(const LogEntry& entry, bool withTime);
+
+    /** Sends the next line of a dump. */
+    void dumpStep();
+
    public:
+    LoggerService();
+
     /**
      * @brief Log a message.
      *
@@ -27,6 +125,73 @@ class LoggerService
      * @param msg The message to log as a Flash string.
      */
     void log(const __FlashStringHelper* msg);
+
+    /**
+     * @brief Log a catalog message.
+     *
+     * Sent as "lo:<text>" or, when built with LOG_DICTIONARY, as "ld:<id>"
+     * to be expanded on the host.
+     *
+     * @param id The catalog entry.
+     */
+    void log(LogId id)
+    {
+        if (isEnabled(id))
+            push(id, false, 0);
+    }
+
+    /**
+     * @brief Log a catalog message with an integer argument.
+     *
+     * Sent as "lo:<text> <arg>" or "ld:<id>,<arg>" with LOG_DICTIONARY.
+     *
+     * @param id The catalog entry.
+     * @param arg The argument printed after the text.
+     */
+    void log(LogId id, int16_t arg)
+    {
+        if (isEnabled(id))
+            push(id, true, arg);
+    }
+
+    /**
+     * @brief Set the runtime level of a module.
+     *
+     * @param module The module.
+     * @param level Most verbose level emitted, LOG_LEVEL_OFF to silence it.
+     * @return true if module and level are valid.
+     */
+    bool setLevel(LogModule module, uint8_t level);
+
+    /**
+     * @brief Look up a module by its tag ("DRONE", "DOOR", "DISTANCE", "HT", ...).
+     *
+     * @param name The tag, case insensitive.
+     * @return LogModule the module, LOG_MODULE_COUNT if unknown.
+     */
+    LogModule moduleFromName(const char* name) const;
+
+    /**
+     * @brief Send pending entries while the serial TX buffer has room.
+     *
+     * Meant to run in the scheduler's background step, never inside a tick.
+     */
+    void drain();
+
+    /**
+     * @brief Send every retained entry again, oldest first, with its timestamp.
+     *
+     * Used for post-mortem analysis (e.g. after an alarm). Nothing is sent
+     * here: drain() streams the dump between a LOG_DUMP header and a
+     * LOG_LOST footer. An entry overwritten before its turn is skipped.
+     * A dump already running is not restarted.
+     */
+    void startDump();
+
+    /**
+     * @brief Number of entries overwritten before being sent since boot.
+     */
+    uint16_t getLostCount() const;
 };
 extern LoggerService Logger;
 
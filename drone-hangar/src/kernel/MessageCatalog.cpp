@@ -0,0 +1,30 @@
+#include "kernel/MessageCatalog.hpp"
+
+#define MESSAGE_TEXT_DEF(id, text)                                           \
+    static_assert(sizeof(text) <= 0xFF, "message too long for its layout"); \
+    static const char MESSAGE_TEXT_##id[] PROGMEM = text;
+#define MESSAGE_TEXT_REF(id, text) MESSAGE_TEXT_##id,
+#define MESSAGE_LAYOUT(id, text) makeMessageLayout(text),
+
+MESSAGE_CATALOG(MESSAGE_TEXT_DEF)
+static const char* const MESSAGE_TEXTS_P[MSG_COUNT] PROGMEM = {MESSAGE_CATALOG(MESSAGE_TEXT_REF)};
+static constexpr MessageLayout MESSAGE_LAYOUTS_P[MSG_COUNT] PROGMEM = {MESSAGE_CATALOG(MESSAGE_LAYOUT)};
+
+#undef MESSAGE_TEXT_DEF
+#undef MESSAGE_TEXT_REF
+#undef MESSAGE_LAYOUT
+
+PGM_P messageText(MessageId id)
+{
+    if (id >= MSG_COUNT)
+        id = MSG_NONE;
+    return (PGM_P)pgm_read_ptr(&MESSAGE_TEXTS_P[id]);
+}
+
+uint8_t messageLine(MessageId id, uint8_t row, PGM_P& text)
+{
+    if (id >= MSG_COUNT || row >= LCD_ROW)
+        return 0;
+    text = messageText(id) + pgm_read_byte(&MESSAGE_LAYOUTS_P[id].start[row]);
+    return pgm_read_byte(&MESSAGE_LAYOUTS_P[id].len[row]);
+}
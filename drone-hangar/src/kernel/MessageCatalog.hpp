@@ -0,0 +1,107 @@
+#ifndef __MESSAGE_CATALOG__
+#define __MESSAGE_CATALOG__
+
+#include <Arduino.h>
+
+#include "config.hpp"
+
+/*
+ * Every fixed text shown on the LCD: X(id, text).
+ *
+ * The texts stay in flash and the Context only carries the 1-byte id. The
+ * word wrapping of each text for LCD_COL x LCD_ROW is computed at compile
+ * time: a row of the layout is a slice of the text (first char, length),
+ * so showing a message is a copy per row, with no parsing at run time.
+ */
+#define MESSAGE_CATALOG(X)                  \
+    X(MSG_NONE, "")                         \
+    X(MSG_REST, LCD_REST_STATE)             \
+    X(MSG_TAKING_OFF, LCD_TAKING_OFF_STATE) \
+    X(MSG_OPERATING, LCD_OPERATING_STATE)   \
+    X(MSG_LANDING, LCD_LANDING_STATE)       \
+    X(MSG_ALARM, LCD_ALARM_STATE)           \
+    X(MSG_TEST_START, "HW TEST START")      \
+    X(MSG_TEST_SENSORS, "SENSORS TEST...")  \
+    X(MSG_TEST_DONE, "TEST DONE")
+
+#define MESSAGE_ID_ENUM(id, text) id,
+
+/**
+ * @brief Identifier of a catalog message.
+ */
+enum MessageId : uint8_t
+{
+    MESSAGE_CATALOG(MESSAGE_ID_ENUM)
+    /// @brief Number of messages, not a message
+    MSG_COUNT
+};
+
+#undef MESSAGE_ID_ENUM
+
+/**
+ * @brief Word-wrapped layout of a message: one slice of the text per row.
+ */
+struct MessageLayout
+{
+    uint8_t start[LCD_ROW]; /**< First char of the row in the text */
+    uint8_t len[LCD_ROW];   /**< Chars of the row, 0 if empty */
+};
+
+/**
+ * @brief Greedy word wrap at compile time, like LCD::print() but with no
+ * limit on the number or length of the words: a word longer than a row
+ * keeps only the chars that fit.
+ */
+constexpr MessageLayout makeMessageLayout(const char* text)
+{
+    MessageLayout l{};
+    uint8_t length = 0;
+    while (text[length] != '\0') length++;
+
+    uint8_t i = 0;
+    for (uint8_t row = 0; row < LCD_ROW; row++)
+    {
+        while (i < length && text[i] == ' ') i++;
+        if (i >= length)
+            break;
+
+        uint8_t start = i;
+        uint8_t end = i;  // end of the last word that fits
+        while (i < length)
+        {
+            uint8_t w = i;
+            while (w < length && text[w] != ' ') w++;
+            if (w - start > LCD_COL)
+                break;
+            end = w;
+            i = w;
+            while (i < length && text[i] == ' ') i++;
+        }
+        if (end == start)
+        {
+            // Word longer than a row: keep a truncated prefix, drop the rest
+            end = start + LCD_COL;
+            while (i < length && text[i] != ' ') i++;
+        }
+        l.start[row] = start;
+        l.len[row] = end - start;
+    }
+    return l;
+}
+
+/**
+ * @brief Text of a message, in flash.
+ */
+PGM_P messageText(MessageId id);
+
+/**
+ * @brief Row of the precomputed layout of a message.
+ *
+ * @param id The message
+ * @param row Row of the display
+ * @param text Set to the first char of the row, in flash
+ * @return uint8_t chars of the row, 0 if the row is empty
+ */
+uint8_t messageLine(MessageId id, uint8_t row, PGM_P& text);
+
+#endif
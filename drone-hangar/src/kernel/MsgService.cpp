@@ -1,6 +1,8 @@
 #include "MsgService.hpp"
 
 #include "config.hpp"
+#include "kernel/BinaryProtocol.hpp"
+#include "kernel/Trace.hpp"
 
 static char serialBuffer[max(JSON_OUT_SIZE, JSON_IN_SIZE)];
 static size_t serialBufferIndex = 0;
@@ -13,6 +15,10 @@ void MsgServiceClass::init(unsigned long baudRate)
     qHead = 0;
     qTail = 0;
     qCount = 0;
+    binaryMode = false;
+    txSeq = 0;
+    fastPath = nullptr;
+    lastRxMicros = 0;
     serialBufferIndex = 0;
 }
 
@@ -59,23 +65,72 @@ bool MsgServiceClass::enqueueMsg(const char* content)
     return true;
 }
 
-void serialEvent()
+void MsgServiceClass::setBinaryMode(bool enabled)
+{
+    binaryMode = enabled;
+    serialBufferIndex = 0;
+}
+
+bool MsgServiceClass::isBinaryMode() const { return binaryMode; }
+
+uint8_t MsgServiceClass::nextSeq() { return txSeq++; }
+
+void MsgServiceClass::sendFrame(const uint8_t* frame, size_t len)
+{
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    if (len == 0 || len > FRAME_MAX_SIZE)
+        return;
+    size_t n = cobsEncode(frame, len, encoded);
+    Serial.write(encoded, n);
+    Serial.write((uint8_t)0);
+}
+
+void MsgServiceClass::setFastPath(MsgHandler handler) { fastPath = handler; }
+
+unsigned long MsgServiceClass::getLastRxMicros() const { return lastRxMicros; }
+
+void MsgServiceClass::deliver(char* content, size_t len)
+{
+    content[len] = '\0';
+    lastRxMicros = micros();
+    Trace.line(millis(), content);
+    if (fastPath && fastPath(content, len))
+        return;
+    enqueueMsg(content);
+}
+
+void MsgServiceClass::poll()
 {
     while (Serial.available())
     {
         char ch = (char)Serial.read();
-        if (ch == '\n')
+        if (binaryMode)
         {
-            if (serialBufferIndex > 0)
+            // COBS frames never contain 0x00, so they fit in a C string as they are
+            if (ch == '\0')
+            {
+                size_t len = serialBufferIndex;
+                serialBufferIndex = 0;
+                if (len > 0)
+                    deliver(serialBuffer, len);
+            }
+            else if (serialBufferIndex < sizeof(serialBuffer) - 1)
             {
-                serialBuffer[serialBufferIndex] = '\0';
-                MsgService.enqueueMsg(serialBuffer);
+                serialBuffer[serialBufferIndex++] = ch;
             }
+        }
+        else if (ch == '\n')
+        {
+            size_t len = serialBufferIndex;
             serialBufferIndex = 0;
+            if (len > 0)
+                deliver(serialBuffer, len);
         }
         else if (ch != '\r' && serialBufferIndex < sizeof(serialBuffer) - 1)
         {
             serialBuffer[serialBufferIndex++] = ch;
         }
     }
-}
\ No newline at end of file
+}
+
+void serialEvent() { MsgService.poll(); }
@@ -16,16 +16,54 @@ class Msg
     const String& getContent() const { return content; }
 };
 
+/**
+ * @brief Handler called from the RX path with a complete message.
+ *
+ * @return true if the message was consumed and must not be queued.
+ */
+typedef bool (*MsgHandler)(const char* content, size_t len);
+
 class MsgServiceClass
 {
    private:
     Msg queue[MSG_SERVICE_QUEUE_SIZE];
     int8_t qHead, qTail, qCount;
+    bool binaryMode;
+    uint8_t txSeq;
+    MsgHandler fastPath;
+    unsigned long lastRxMicros;
+
+    /** Hands a complete message to the fast path or queues it. */
+    void deliver(char* content, size_t len);
 
    public:
     void init(unsigned long baudRate);
     bool isMsgAvailable();
 
+    /**
+     * @brief Read the bytes received so far and deliver complete messages.
+     *
+     * Called by serialEvent() and by the scheduler while it waits for the
+     * next slot, so a message is handled as soon as its delimiter arrives.
+     */
+    void poll();
+
+    /**
+     * @brief Install a handler that consumes messages directly in the RX path.
+     *
+     * Messages it does not consume still go through the queue.
+     *
+     * @param handler the handler, nullptr to queue every message.
+     */
+    void setFastPath(MsgHandler handler);
+
+    /**
+     * @brief Time at which the delimiter of the last message was read.
+     *
+     * @return unsigned long micros() timestamp.
+     */
+    unsigned long getLastRxMicros() const;
+
     /**
      * @brief Receive a message from the queue.
      *
@@ -74,6 +112,38 @@ class MsgServiceClass
      * @return false if the queue is full.
      */
     bool enqueueMsg(const char* content);
+
+    /**
+     * @brief Switch between JSON lines and COBS framed binary messages.
+     *
+     * In binary mode incoming messages are delimited by 0x00 instead of
+     * '\n' and their content is the still COBS-encoded frame.
+     *
+     * @param enabled true to use the binary protocol.
+     */
+    void setBinaryMode(bool enabled);
+
+    /**
+     * @brief Check which protocol is in use.
+     *
+     * @return true if the binary protocol has been negotiated.
+     */
+    bool isBinaryMode() const;
+
+    /**
+     * @brief COBS-encode a raw frame and send it followed by the 0x00 delimiter.
+     *
+     * @param frame raw frame as produced by FrameWriter.
+     * @param len size of the raw frame.
+     */
+    void sendFrame(const uint8_t* frame, size_t len);
+
+    /**
+     * @brief Next sequence number for an outgoing frame.
+     *
+     * @return uint8_t the sequence number, wraps at 256.
+     */
+    uint8_t nextSeq();
 };
 
 extern MsgServiceClass MsgService;
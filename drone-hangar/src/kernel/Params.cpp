@@ -0,0 +1,156 @@
+#include "Params.hpp"
+
+#include <EEPROM.h>
+#include <avr/eeprom.h>
+
+#include "kernel/BinaryProtocol.hpp"
+#include "kernel/Journal.hpp"
+#include "kernel/PerfectHash.hpp"
+
+#define PARAM_MAGIC 0xA5
+#define PARAM_HEADER_SIZE 3
+#define PARAM_CRC_ADDR (PARAM_EEPROM_ADDR + PARAM_HEADER_SIZE + 2 * PARAM_COUNT)
+#define PARAM_BLOCK_SIZE (PARAM_CRC_ADDR + 2 - PARAM_EEPROM_ADDR)
+
+static_assert(PARAM_CRC_ADDR + 2 <= JOURNAL_EEPROM_ADDR, "parameter block overlaps the journal");
+
+#define PARAM_NAME(id, name, def, min, max) name,
+#define PARAM_NAME_DEF(id, name, def, min, max) static const char PARAM_NAME_##id[] PROGMEM = name;
+#define PARAM_NAME_REF(id, name, def, min, max) PARAM_NAME_##id,
+#define PARAM_LIMITS(id, name, def, min, max) {def, min, max},
+
+static constexpr const char* PARAM_NAMES[PARAM_COUNT] = {PARAM_CATALOG(PARAM_NAME)};
+PARAM_CATALOG(PARAM_NAME_DEF)
+static const char* const PARAM_NAMES_P[PARAM_COUNT] PROGMEM = {PARAM_CATALOG(PARAM_NAME_REF)};
+
+struct ParamLimits
+{
+    uint16_t def;
+    uint16_t min;
+    uint16_t max;
+};
+static const ParamLimits PARAM_LIMITS_P[PARAM_COUNT] PROGMEM = {PARAM_CATALOG(PARAM_LIMITS)};
+
+#undef PARAM_NAME
+#undef PARAM_NAME_DEF
+#undef PARAM_NAME_REF
+#undef PARAM_LIMITS
+
+static constexpr PerfectHashTable<PARAM_COUNT> PARAM_HASH PROGMEM = makePerfectHash(PARAM_NAMES);
+static_assert(PARAM_HASH.ok, "parameter names collide, rename one or raise PERFECT_HASH_MAX_DISP");
+
+ParamRegistry Params;
+
+ParamRegistry::ParamRegistry() : nBindings(0), saveIndex(PARAM_BLOCK_SIZE) { loadDefaults(); }
+
+void ParamRegistry::loadDefaults()
+{
+    for (uint8_t i = 0; i < PARAM_COUNT; i++)
+    {
+        values[i] = pgm_read_word(&PARAM_LIMITS_P[i].def);
+    }
+}
+
+uint16_t ParamRegistry::blockCrc() const
+{
+    const uint8_t header[PARAM_HEADER_SIZE] = {PARAM_MAGIC, PARAM_VERSION, PARAM_COUNT};
+    uint16_t crc = crc16(header, sizeof(header));
+    return crc16((const uint8_t*)values, sizeof(values), crc);
+}
+
+bool ParamRegistry::load()
+{
+    if (EEPROM.read(PARAM_EEPROM_ADDR) == PARAM_MAGIC && EEPROM.read(PARAM_EEPROM_ADDR + 1) == PARAM_VERSION &&
+        EEPROM.read(PARAM_EEPROM_ADDR + 2) == PARAM_COUNT)
+    {
+        for (uint8_t i = 0; i < PARAM_COUNT; i++)
+        {
+            EEPROM.get(PARAM_EEPROM_ADDR + PARAM_HEADER_SIZE + 2 * i, values[i]);
+        }
+        uint16_t stored;
+        EEPROM.get(PARAM_CRC_ADDR, stored);
+        if (stored == blockCrc() && isConsistent())
+            return true;
+    }
+
+    loadDefaults();
+    saveIndex = 0;
+    return false;
+}
+
+uint8_t ParamRegistry::blockByte(uint8_t i) const
+{
+    switch (i)
+    {
+        case 0:
+            return PARAM_MAGIC;
+        case 1:
+            return PARAM_VERSION;
+        case 2:
+            return PARAM_COUNT;
+    }
+    if (i < PARAM_CRC_ADDR - PARAM_EEPROM_ADDR)
+        return ((const uint8_t*)values)[i - PARAM_HEADER_SIZE];
+    // Little endian, as EEPROM.get() reads it back
+    uint16_t crc = blockCrc();
+    return i == PARAM_CRC_ADDR - PARAM_EEPROM_ADDR ? (uint8_t)crc : (uint8_t)(crc >> 8);
+}
+
+void ParamRegistry::flush()
+{
+    if (saveIndex >= PARAM_BLOCK_SIZE || !eeprom_is_ready())
+        return;
+    EEPROM.update(PARAM_EEPROM_ADDR + saveIndex, blockByte(saveIndex));
+    saveIndex++;
+}
+
+bool ParamRegistry::isConsistent() const
+{
+    // Pre-alarm below alarm, landing threshold below take-off threshold
+    return values[PARAM_TEMP1] < values[PARAM_TEMP2] && values[PARAM_D2] < values[PARAM_D1];
+}
+
+bool ParamRegistry::set(ParamId id, uint16_t value)
+{
+    if (id >= PARAM_COUNT || value < pgm_read_word(&PARAM_LIMITS_P[id].min) ||
+        value > pgm_read_word(&PARAM_LIMITS_P[id].max))
+        return false;
+
+    uint16_t old = values[id];
+    values[id] = value;
+    if (!isConsistent())
+    {
+        values[id] = old;
+        return false;
+    }
+    saveIndex = 0;
+
+    for (uint8_t i = 0; i < nBindings; i++)
+    {
+        if (bindings[i].id == id)
+            bindings[i].task->setPeriod(value);
+    }
+    return true;
+}
+
+bool ParamRegistry::bindPeriod(ParamId id, Task* task)
+{
+    if (nBindings >= MAX_PARAM_BINDINGS)
+        return false;
+    bindings[nBindings++] = {id, task};
+    return true;
+}
+
+ParamId ParamRegistry::fromName(const char* name) const
+{
+    uint8_t disp = pgm_read_byte(&PARAM_HASH.disp[perfectHash(name, 0) % PARAM_COUNT]);
+    uint8_t k = pgm_read_byte(&PARAM_HASH.key[perfectHash(name, disp) % PARAM_COUNT]);
+    if (strcasecmp_P(name, (PGM_P)pgm_read_ptr(&PARAM_NAMES_P[k])) != 0)
+        return PARAM_COUNT;
+    return (ParamId)k;
+}
+
+const __FlashStringHelper* ParamRegistry::nameOf(ParamId id) const
+{
+    return (const __FlashStringHelper*)pgm_read_ptr(&PARAM_NAMES_P[id]);
+}
@@ -0,0 +1,149 @@
+#ifndef __PARAMS__
+#define __PARAMS__
+
+#include <Arduino.h>
+
+#include "config.hpp"
+#include "kernel/Task.hpp"
+
+/*
+ * Runtime-tunable parameters: X(id, name, default, min, max).
+ *
+ * Defaults come from config.hpp; distances are stored in mm. The position
+ * in the list is the parameter code of the binary protocol and the slot in
+ * EEPROM, so append new entries at the end and bump PARAM_VERSION when the
+ * meaning of an existing one changes.
+ */
+#define PARAM_CATALOG(X)                                                                    \
+    X(D1, "d1", (uint16_t)(D1 * 1000), 0, 4000)                                             \
+    X(D2, "d2", (uint16_t)(D2 * 1000), 0, 4000)                                             \
+    X(TIME1, "time1", TIME1, 0, 60000)                                                      \
+    X(TIME2, "time2", TIME2, 0, 60000)                                                      \
+    X(TIME3, "time3", TIME3, 0, 60000)                                                      \
+    X(TIME4, "time4", TIME4, 0, 60000)                                                      \
+    X(TEMP1, "temp1", TEMP1, 0, 100)                                                        \
+    X(TEMP2, "temp2", TEMP2, 0, 100)                                                        \
+    X(MOVING_TIME, "moving_time", MOVING_TIME, 100, 10000)                                  \
+    X(DOOR_OPEN_ANGLE, "door_angle", DOOR_OPEN_ANGLE, 10, 180)                              \
+    X(DRONE_PERIOD, "drone_period", DRONE_TASK_PERIOD, BASE_PERIOD_MS, 10000)               \
+    X(DOOR_PERIOD, "door_period", DOOR_CONTROL_TASK_PERIOD, BASE_PERIOD_MS, 10000)          \
+    X(HANGAR_PERIOD, "hangar_period", HANGAR_TASK_PERIOD, BASE_PERIOD_MS, 10000)            \
+    X(DISTANCE_PERIOD, "distance_period", DISTANCE_TASK_PERIOD, BASE_PERIOD_MS, 10000)      \
+    X(LCD_PERIOD, "lcd_period", LCD_TASK_PERIOD, BASE_PERIOD_MS, 10000)                     \
+    X(MSG_PERIOD, "msg_period", MSG_TASK_PERIOD, BASE_PERIOD_MS, 10000)                     \
+    X(BLINK_PERIOD, "blink_period", L2_BLINK_PERIOD, BASE_PERIOD_MS, 10000)
+
+#define PARAM_ID_ENUM(id, name, def, min, max) PARAM_##id,
+
+/**
+ * @brief Identifier of a tunable parameter.
+ */
+enum ParamId : uint8_t
+{
+    PARAM_CATALOG(PARAM_ID_ENUM) PARAM_COUNT
+};
+
+#undef PARAM_ID_ENUM
+
+/** @brief Change it when stored values must not be reused (resets to defaults). */
+#define PARAM_VERSION 1
+
+/** @brief EEPROM address of the parameter block. */
+#define PARAM_EEPROM_ADDR 0
+
+/** @brief Max number of tasks whose period follows a parameter. */
+#define MAX_PARAM_BINDINGS 8
+
+/**
+ * @brief Typed parameter registry persisted in EEPROM.
+ *
+ * Values are cached in RAM, so get() is a plain array read. The EEPROM
+ * block is [magic][version][count][values...][crc16]; a block that does
+ * not match is replaced by the defaults. set() only changes the RAM copy:
+ * the block is written back a byte at a time by flush(), so a command
+ * never waits for the EEPROM.
+ */
+class ParamRegistry
+{
+   private:
+    uint16_t values[PARAM_COUNT];
+
+    struct Binding
+    {
+        ParamId id;
+        Task* task;
+    };
+    Binding bindings[MAX_PARAM_BINDINGS];
+    uint8_t nBindings;
+    uint8_t saveIndex; /**< Next block byte to write, PARAM_BLOCK_SIZE when saved */
+
+    void loadDefaults();
+    uint16_t blockCrc() const;
+    bool isConsistent() const;
+    uint8_t blockByte(uint8_t i) const;
+
+   public:
+    ParamRegistry();
+
+    /**
+     * @brief Load the values from EEPROM, falling back to the defaults.
+     *
+     * @return true if the stored block was valid.
+     */
+    bool load();
+
+    /**
+     * @brief Write at most one byte of the block if the EEPROM is idle.
+     *
+     * Meant as a Scheduler background step, like Journal.flush(). Only
+     * changed bytes are written; a change during the write starts it over,
+     * so the CRC always covers the values written with it.
+     */
+    void flush();
+
+    /**
+     * @brief Current value of a parameter.
+     *
+     * @param id The parameter.
+     * @return uint16_t the cached value.
+     */
+    uint16_t get(ParamId id) const { return values[id]; }
+
+    /**
+     * @brief Validate and apply a new value, and schedule its write.
+     *
+     * Bound tasks get their new period immediately; flush() persists it.
+     *
+     * @param id The parameter.
+     * @param value The new value.
+     * @return true if the id exists, the value is within range and the
+     * thresholds stay ordered (TEMP1 < TEMP2, D2 < D1).
+     */
+    bool set(ParamId id, uint16_t value);
+
+    /**
+     * @brief Make a task period follow a parameter.
+     *
+     * @param id The period parameter.
+     * @param task The task to reconfigure when it changes.
+     * @return true if the binding was added, false if there is no room left.
+     */
+    bool bindPeriod(ParamId id, Task* task);
+
+    /**
+     * @brief Look up a parameter by name, through the same perfect hash as commands.
+     *
+     * @param name The name, case insensitive.
+     * @return ParamId the parameter, PARAM_COUNT if unknown.
+     */
+    ParamId fromName(const char* name) const;
+
+    /**
+     * @brief Name of a parameter, in flash.
+     */
+    const __FlashStringHelper* nameOf(ParamId id) const;
+};
+
+extern ParamRegistry Params;
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef __PERFECT_HASH__
+#define __PERFECT_HASH__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Minimal perfect hash over a fixed set of names, built at compile time
+ * with hash-and-displace:
+ *
+ *   bucket = hash(name, 0) % N
+ *   slot   = hash(name, disp[bucket]) % N
+ *
+ * Buckets are placed largest first, each one with the first displacement
+ * that sends all its names to free slots. A lookup costs two hashes and
+ * one final string compare against the only candidate, whatever N is.
+ *
+ * Hashing is case insensitive. Like BinaryProtocol.hpp, this header has no
+ * Arduino dependency so host tools can use it too. Needs C++14 constexpr.
+ */
+
+/** @brief Displacements tried per bucket before giving up. */
+#define PERFECT_HASH_MAX_DISP 255
+
+/**
+ * @brief FNV-1a over the lower-cased name, seeded with a displacement.
+ *
+ * The final mix spreads the high bits down: without it the low bits, and
+ * so the slot for a power-of-two N, would not depend on the seed.
+ */
+constexpr uint32_t perfectHash(const char* name, uint8_t seed)
+{
+    uint32_t h = 2166136261UL ^ seed;
+    for (; *name; name++)
+    {
+        char c = (*name >= 'A' && *name <= 'Z') ? (char)(*name + ('a' - 'A')) : *name;
+        h = (h ^ (uint8_t)c) * 16777619UL;
+    }
+    h ^= h >> 16;
+    h *= 0x7FEB352DUL;
+    return h ^ (h >> 15);
+}
+
+/**
+ * @brief Generated tables. Both arrays have one byte per name.
+ */
+template <size_t N>
+struct PerfectHashTable
+{
+    uint8_t disp[N];    /**< Displacement of every bucket */
+    uint8_t key[N];     /**< Index of the name stored in every slot */
+    bool ok;            /**< false if two names collide (or are equal) */
+};
+
+constexpr bool perfectHashEqual(const char* a, const char* b)
+{
+    for (; *a && *b; a++, b++)
+    {
+        char ca = (*a >= 'A' && *a <= 'Z') ? (char)(*a + ('a' - 'A')) : *a;
+        char cb = (*b >= 'A' && *b <= 'Z') ? (char)(*b + ('a' - 'A')) : *b;
+        if (ca != cb)
+            return false;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Builds the tables for @p names. Check the result with a
+ * static_assert on ok, so a colliding definition does not compile.
+ */
+template <size_t N>
+constexpr PerfectHashTable<N> makePerfectHash(const char* const (&names)[N])
+{
+    PerfectHashTable<N> t{};
+    t.ok = N < 0xFF;
+
+    uint8_t bucketOf[N]{};
+    uint8_t bucketSize[N]{};
+    bool used[N]{};
+    for (size_t k = 0; k < N; k++)
+    {
+        for (size_t j = 0; j < k; j++)
+        {
+            if (perfectHashEqual(names[j], names[k]))
+                t.ok = false;
+        }
+        bucketOf[k] = (uint8_t)(perfectHash(names[k], 0) % N);
+        bucketSize[bucketOf[k]]++;
+    }
+
+    for (size_t size = N; size > 0 && t.ok; size--)
+    {
+        for (size_t b = 0; b < N && t.ok; b++)
+        {
+            if (bucketSize[b] != size)
+                continue;
+
+            bool placed = false;
+            for (unsigned d = 0; d <= PERFECT_HASH_MAX_DISP && !placed; d++)
+            {
+                uint8_t slots[N]{};
+                size_t n = 0;
+                bool fits = true;
+                for (size_t k = 0; k < N && fits; k++)
+                {
+                    if (bucketOf[k] != b)
+                        continue;
+                    uint8_t s = (uint8_t)(perfectHash(names[k], (uint8_t)d) % N);
+                    fits = !used[s];
+                    for (size_t i = 0; i < n && fits; i++)
+                    {
+                        fits = slots[i] != s;
+                    }
+                    slots[n++] = s;
+                }
+                if (!fits)
+                    continue;
+
+                placed = true;
+                t.disp[b] = (uint8_t)d;
+                n = 0;
+                for (size_t k = 0; k < N; k++)
+                {
+                    if (bucketOf[k] == b)
+                    {
+                        used[slots[n++]] = true;
+                        t.key[slots[n - 1]] = (uint8_t)k;
+                    }
+                }
+            }
+            t.ok = placed;
+        }
+    }
+    return t;
+}
+
+#endif
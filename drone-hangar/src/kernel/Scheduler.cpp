@@ -1,6 +1,11 @@
 #include "Scheduler.hpp"
 
+#include <Arduino.h>
 #include <TimerOne.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "config.hpp"
 
 volatile bool timerFlag;
 
@@ -14,6 +19,7 @@ void Scheduler::init(int basePeriod)
     Timer1.initialize(period);
     Timer1.attachInterrupt(timerHandler);
     nTasks = 0;
+    nBackgroundSteps = 0;
 }
 
 bool Scheduler::addTask(Task* task)
@@ -30,17 +36,54 @@ bool Scheduler::addTask(Task* task)
     }
 }
 
+bool Scheduler::addBackgroundStep(void (*step)())
+{
+    if (nBackgroundSteps < MAX_BACKGROUND_STEPS)
+    {
+        backgroundSteps[nBackgroundSteps] = step;
+        nBackgroundSteps++;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 void Scheduler::schedule()
 {
     while (!timerFlag)
     {
+        for (int i = 0; i < nBackgroundSteps && !timerFlag; i++)
+        {
+            backgroundSteps[i]();
+        }
+#ifdef SCHED_IDLE_SLEEP
+        // Idle mode keeps timers, UART and pin interrupts running, and any
+        // of them wakes the CPU. sei() takes effect after the next
+        // instruction, so the timer cannot fire between the check and the sleep.
+        cli();
+        if (!timerFlag)
+        {
+            set_sleep_mode(SLEEP_MODE_IDLE);
+            sleep_enable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+        }
+        sei();
+#endif
     }
     timerFlag = false;
+    unsigned long slotStart = micros();
+    unsigned long slotUs = 1000UL * basePeriod - SCHED_SLACK_US;
 
     for (int i = 0; i < nTasks; i++)
     {
         if (taskList[i]->isActive())
         {
+            unsigned long used = micros() - slotStart;
+            taskList[i]->setBudget(used < slotUs ? slotUs - used : 0);
             if (taskList[i]->isPeriodic())
             {
                 if (taskList[i]->updateAndCheckTime(basePeriod))
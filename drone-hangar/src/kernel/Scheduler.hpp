@@ -4,6 +4,10 @@
 #include "Task.hpp"
 
 #define MAX_TASKS 50
+#define MAX_BACKGROUND_STEPS 4
+
+/** @brief Part of the slot (us) never handed out as task budget. */
+#define SCHED_SLACK_US 5000
 
 /**
  * @brief Scheduler class for managing and executing tasks.
@@ -15,6 +19,8 @@ class Scheduler
     int basePeriod;
     int nTasks;
     Task* taskList[MAX_TASKS];
+    int nBackgroundSteps;
+    void (*backgroundSteps[MAX_BACKGROUND_STEPS])();
 
    public:
     /**
@@ -33,9 +39,24 @@ class Scheduler
      */
     virtual bool addTask(Task* task);
 
+    /**
+     * @brief Add a low priority step run while waiting for the next slot.
+     *
+     * Background steps run repeatedly in the idle time left after the
+     * tasks, so they must be short and non-blocking. With SCHED_IDLE_SLEEP
+     * the CPU sleeps after each round until the next interrupt.
+     *
+     * @param step function to call
+     * @return true if the step was added successfully
+     * @return false if there is no room left
+     */
+    bool addBackgroundStep(void (*step)());
+
     /**
      * @brief Schedule tasks according to their periods.
      *
+     * Before each tick() the task gets as budget what is left of the slot,
+     * minus SCHED_SLACK_US.
      */
     virtual void schedule();
 };
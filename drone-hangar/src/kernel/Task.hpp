@@ -13,12 +13,17 @@ class Task
     bool active;
     bool periodic;
     bool completed;
+    unsigned long budget;
 
    public:
     /**
      * Default constructor. Initializes the task as inactive.
      */
-    Task() { this->active = false; }
+    Task()
+    {
+        this->active = false;
+        this->budget = 0;
+    }
 
     /**
      * Initialize the task as periodic with the given period.
@@ -73,6 +78,32 @@ class Task
         }
     }
 
+    /**
+     * Change the period of a periodic task, from the next slot on.
+     * @param period new period in milliseconds
+     */
+    void setPeriod(unsigned long period) { this->myPeriod = period; }
+
+    /**
+     * Make a periodic task run at the next scheduler slot, whatever is
+     * left of its period. Used to react to events without polling faster.
+     */
+    void wake() { this->timeElapsed = this->myPeriod; }
+
+    /**
+     * Set the time the next tick() may take. The scheduler sets it before
+     * every tick() to what is left of the slot.
+     * @param us budget in microseconds
+     */
+    void setBudget(unsigned long us) { this->budget = us; }
+
+    /**
+     * Time the current tick() may take without running into the next slot.
+     * Only tasks doing divisible work (e.g. LCD flushing) need to look at it.
+     * @return budget in microseconds
+     */
+    unsigned long getBudget() { return this->budget; }
+
     /**
      * Mark the task as completed and deactivate it (for one-shot tasks).
      */
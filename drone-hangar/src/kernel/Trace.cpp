@@ -0,0 +1,42 @@
+#include "kernel/Trace.hpp"
+
+#include "kernel/MsgService.hpp"
+
+TraceService Trace;
+
+#ifdef TRACE_CAPTURE
+
+TraceService::TraceService() : last(0) {}
+
+bool TraceService::begin(unsigned long time, TraceKind kind)
+{
+    if (MsgService.isBinaryMode())
+        return false;
+
+    char num[12];
+    ltoa((long)(time - last), num, 10);
+    last = time;
+    MsgService.sendMsgRaw("tr:", false);
+    MsgService.sendMsgRaw(num, false);
+    num[0] = (char)kind;
+    num[1] = '\0';
+    MsgService.sendMsgRaw(num, false);
+    return true;
+}
+
+void TraceService::sample(TraceKind kind, unsigned long time, long value)
+{
+    if (!begin(time, kind))
+        return;
+    char num[12];
+    ltoa(value, num, 10);
+    MsgService.sendMsgRaw(num, true);
+}
+
+void TraceService::line(unsigned long time, const char* text)
+{
+    if (begin(time, TRACE_SERIAL))
+        MsgService.sendMsgRaw(text, true);
+}
+
+#endif
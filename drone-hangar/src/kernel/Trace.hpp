@@ -0,0 +1,73 @@
+#ifndef __TRACE__
+#define __TRACE__
+
+#include <Arduino.h>
+
+/**
+ * @brief Kind of a trace record, sent as its letter.
+ */
+enum TraceKind : char
+{
+    TRACE_TEMP = 't',     /**< Temperature sample, 0.01 degC */
+    TRACE_DISTANCE = 'd', /**< Sonar sample, mm, negative without echo */
+    TRACE_PIR = 'p',      /**< PIR edge, 1 rising */
+    TRACE_BUTTON = 'b',   /**< Debounced button edge, 1 pressed */
+    TRACE_SERIAL = 's'    /**< Inbound serial line */
+};
+
+/**
+ * @brief Capture of the inputs, built with TRACE_CAPTURE.
+ *
+ * Every value read from a sensor, every PIR and button edge and every
+ * inbound line is sent as it is taken, one line per record:
+ *
+ *   tr:<dt><kind><value>
+ *
+ * where dt is the signed ms since the previous record (edges carry their
+ * interrupt time, so they can be a little older), kind a TraceKind letter
+ * and value an integer, or the line for TRACE_SERIAL. tools/tracecap.cpp
+ * turns the records into a script for the native build, which replays
+ * them into the simulated devices.
+ *
+ * Records are written straight to Serial and wait for room in the TX
+ * buffer: none is dropped, at the cost of the slot time. They pause in
+ * binary mode, where a text line would break the framing. Without
+ * TRACE_CAPTURE the calls are empty and compile to nothing.
+ */
+class TraceService
+{
+#ifdef TRACE_CAPTURE
+   private:
+    unsigned long last; /**< Time of the previous record */
+
+    bool begin(unsigned long time, TraceKind kind);
+
+   public:
+    TraceService();
+
+    /**
+     * @brief Record a sample or an edge.
+     *
+     * @param kind What was read.
+     * @param time millis() it was read at.
+     * @param value The value, in the unit of the kind.
+     */
+    void sample(TraceKind kind, unsigned long time, long value);
+
+    /**
+     * @brief Record an inbound serial line.
+     *
+     * @param time millis() it was received at.
+     * @param text The line, without the delimiter.
+     */
+    void line(unsigned long time, const char* text);
+#else
+   public:
+    void sample(TraceKind, unsigned long, long) {}
+    void line(unsigned long, const char*) {}
+#endif
+};
+
+extern TraceService Trace;
+
+#endif
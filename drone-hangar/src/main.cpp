@@ -1,19 +1,24 @@
 #include <Arduino.h>
 
 #include "config.hpp"
+#include "kernel/BootProfile.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
 #include "kernel/MsgService.hpp"
+#include "kernel/Params.hpp"
 #include "kernel/Scheduler.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
 #include "model/HWPlatform.hpp"
-#include "task/BlinkingTask.hpp"
+#include "model/LedPatterns.hpp"
+#include "task/AcquisitionTask.hpp"
 #include "task/DistanceTask.hpp"
 #include "task/DoorControlTask.hpp"
 #include "task/DroneTask.hpp"
 #include "task/HangarTask.hpp"
 #include "task/LCDTask.hpp"
 #include "task/MSGTask.hpp"
+#include "task/SnapshotTask.hpp"
 
 /* ======== Global Vars ======== */
 Scheduler sched;
@@ -30,63 +35,99 @@ Context* pContext;
 #include "MemoryFree.h"
 #endif
 
+static void pollSerial() { MsgService.poll(); }
+static void drainLogs() { Logger.drain(); }
+static void flushJournal() { Journal.flush(); }
+static void flushParams() { Params.flush(); }
+
 void setup() {
+  BootProfile.begin();
+
   /* ======== Message Service ======== */
   MsgService.init(BAUD_RATE);
   sched.init(BASE_PERIOD_MS);
+  sched.addBackgroundStep(pollSerial);
+  sched.addBackgroundStep(drainLogs);
+  sched.addBackgroundStep(flushJournal);
+  sched.addBackgroundStep(flushParams);
+  BootProfile.mark(BOOT_SERIAL);
+
+  /* ======== Parameters ======== */
+  Params.load();
+  Journal.init();
+  BootProfile.mark(BOOT_STORAGE);
 
   /* ======== Hardware Platform ======== */
   pHWPlatform = new HWPlatform();
   pHWPlatform->init();
 
+  /* ======== LEDs (timer interrupt, no task) ======== */
+  LedPatterns.attach(LED_L1, L1_PIN);
+  LedPatterns.attach(LED_L2, L2_PIN);
+  LedPatterns.attach(LED_L3, L3_PIN);
+  LedPatterns.init();
+
 #ifndef __TESTING_HW__
   /* ======== Context ======== */
   pContext = new Context();
 
   /* ======== Task Initialization ======== */
-  Task* pDroneTask = new DroneTask(pContext, pHWPlatform->getL1(),
-                                   pHWPlatform->getPresenceSensor());
-  pDroneTask->init(DRONE_TASK_PERIOD);
+  AcquisitionTask* pAcquisitionTask = new AcquisitionTask(pHWPlatform, pContext);
+  pAcquisitionTask->init(BASE_PERIOD_MS);
+  const SensorReadings* pReadings = pAcquisitionTask->getReadings();
 
-  Task* pLcdTask = new LCDTask(pHWPlatform->getLCD(), pContext);
-  pLcdTask->init(LCD_TASK_PERIOD);
+  Task* pDroneTask = new DroneTask(pContext, pReadings);
+  pDroneTask->init(Params.get(PARAM_DRONE_PERIOD));
+  Params.bindPeriod(PARAM_DRONE_PERIOD, pDroneTask);
 
-  Task* pMSGTask = new MsgTask(pContext, &MsgService);
-  pMSGTask->init(MSG_TASK_PERIOD);
+  Task* pLcdTask = new LCDTask(pHWPlatform->getLCD(), pContext);
+  pLcdTask->init(Params.get(PARAM_LCD_PERIOD));
+  Params.bindPeriod(PARAM_LCD_PERIOD, pLcdTask);
 
-  Task* pHangarTask =
-      new HangarTask(pHWPlatform->getTempSensor(), pHWPlatform->getButton(),
-                     pHWPlatform->getL3(), pContext);
-  pHangarTask->init(HANGAR_TASK_PERIOD);
+  MsgTask* pMSGTask = new MsgTask(pContext, &MsgService, pHWPlatform->getLCD());
+  pMSGTask->init(Params.get(PARAM_MSG_PERIOD));
+  Params.bindPeriod(PARAM_MSG_PERIOD, pMSGTask);
 
-  Task* pBlinkingTask = new BlinkingTask(pHWPlatform->getL2(), pContext);
-  pBlinkingTask->init(L2_BLINK_PERIOD);
+  Task* pHangarTask = new HangarTask(pReadings, pContext);
+  pHangarTask->init(Params.get(PARAM_HANGAR_PERIOD));
+  Params.bindPeriod(PARAM_HANGAR_PERIOD, pHangarTask);
 
   Task* pDoorControlTask =
       new DoorControlTask(pContext, pHWPlatform->getMotor());
-  pDoorControlTask->init(DOOR_CONTROL_TASK_PERIOD);
+  pDoorControlTask->init(Params.get(PARAM_DOOR_PERIOD));
+  Params.bindPeriod(PARAM_DOOR_PERIOD, pDoorControlTask);
+
+  Task* pDistanceTask = new DistanceTask(pReadings, pContext);
+  pDistanceTask->init(Params.get(PARAM_DISTANCE_PERIOD));
+  Params.bindPeriod(PARAM_DISTANCE_PERIOD, pDistanceTask);
+
+  Task* pSnapshotTask = new SnapshotTask(pContext);
+  pSnapshotTask->init(BASE_PERIOD_MS);
 
-  Task* pDistanceTask =
-      new DistanceTask(pHWPlatform->getProximitySensor(), pContext);
-  pDistanceTask->init(DISTANCE_TASK_PERIOD);
+  /* ======== Command Fast Path ======== */
+  pMSGTask->addCommandListener(pDroneTask);
+  pMSGTask->addCommandListener(pDoorControlTask);
 
   /* ======== Task Registration in Scheduler ======== */
+  sched.addTask(pAcquisitionTask);  // devices sampled once, before everyone
   sched.addTask(pDroneTask);
   sched.addTask(pHangarTask);
-  sched.addTask(pBlinkingTask);
   sched.addTask(pDoorControlTask);
   sched.addTask(pDistanceTask);
+  sched.addTask(pSnapshotTask);  // writers above, readers below
   sched.addTask(pLcdTask);
   sched.addTask(pMSGTask);
 
-  Logger.log(F(":::::: Drone Hangar Ready ::::::"));
+  BootProfile.mark(BOOT_TASKS);
+  BootProfile.report();
+  Logger.log(LOG_HANGAR_READY);
 #endif
 
 #ifdef __TESTING_HW__
   Task* pTestHWTask = new TestHWTask(pHWPlatform);
   pTestHWTask->init(200);
   sched.addTask(pTestHWTask);
-  Logger.log(F(":::::: Hardware Testing Mode ::::::"));
+  Logger.log(LOG_HW_TEST_MODE);
 #endif
 }
 
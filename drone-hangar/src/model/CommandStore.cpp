@@ -0,0 +1,99 @@
+#include "model/CommandStore.hpp"
+
+#include "config.hpp"
+
+CommandStore::CommandStore() : freeHead(0), pending(0), overflows(0), expired(0)
+{
+    for (uint8_t i = 0; i < CMD_POOL_SIZE; i++)
+    {
+        pool[i].next = (i + 1 < CMD_POOL_SIZE) ? i + 1 : CMD_NONE;
+    }
+    for (uint8_t t = 0; t < (uint8_t)CommandType::COUNT; t++)
+    {
+        lists[t] = {CMD_NONE, CMD_NONE, 0};
+    }
+}
+
+bool CommandStore::push(CommandType cmd, uint32_t now)
+{
+    uint8_t t = (uint8_t)cmd;
+    if (t >= (uint8_t)CommandType::COUNT)
+        return false;
+
+    TypeList& list = lists[t];
+    if (list.count >= CMD_MAX_PER_TYPE || freeHead == CMD_NONE)
+    {
+        if (overflows < 0xFFFF)
+            overflows++;
+        return false;
+    }
+
+    uint8_t i = freeHead;
+    freeHead = pool[i].next;
+    pool[i].deadline = now + CONFIG_CMD_TTL_MS;
+    pool[i].next = CMD_NONE;
+
+    if (list.count == 0)
+        list.head = i;
+    else
+        pool[list.tail].next = i;
+    list.tail = i;
+    list.count++;
+    pending |= 1UL << t;
+    return true;
+}
+
+void CommandStore::dropHead(uint8_t type)
+{
+    TypeList& list = lists[type];
+    uint8_t i = list.head;
+    list.head = pool[i].next;
+    pool[i].next = freeHead;
+    freeHead = i;
+    if (--list.count == 0)
+    {
+        list.tail = CMD_NONE;
+        pending &= ~(1UL << type);
+    }
+}
+
+bool CommandStore::pop(CommandType cmd, uint32_t now)
+{
+    uint8_t t = (uint8_t)cmd;
+    if (t >= (uint8_t)CommandType::COUNT)
+        return false;
+
+    while (lists[t].count > 0)
+    {
+        bool live = (int32_t)(now - pool[lists[t].head].deadline) < 0;
+        dropHead(t);
+        if (live)
+            return true;
+        if (expired < 0xFFFF)
+            expired++;
+    }
+    return false;
+}
+
+void CommandStore::expire(uint32_t now)
+{
+    uint32_t mask = pending;
+    for (uint8_t t = 0; mask != 0; t++, mask >>= 1)
+    {
+        // Same TTL for every entry: only the head of a list can be the oldest
+        while ((mask & 1) && lists[t].count > 0 && (int32_t)(now - pool[lists[t].head].deadline) >= 0)
+        {
+            dropHead(t);
+            if (expired < 0xFFFF)
+                expired++;
+        }
+    }
+}
+
+bool CommandStore::isPending(CommandType cmd) const { return (pending >> (uint8_t)cmd) & 1; }
+
+uint32_t CommandStore::getPendingMask() const { return pending; }
+
+uint16_t CommandStore::getOverflows() const { return overflows; }
+
+uint16_t CommandStore::getExpired() const { return expired; }
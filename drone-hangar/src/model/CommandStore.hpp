@@ -0,0 +1,95 @@
+#ifndef __COMMAND_STORE__
+#define __COMMAND_STORE__
+
+#include <stdint.h>
+
+#include "kernel/CommandType.hpp"
+
+/** @brief Number of command entries shared by all the command types. */
+#define CMD_POOL_SIZE 8
+
+/** @brief Max number of pending entries of the same command type. */
+#define CMD_MAX_PER_TYPE 2
+
+/** @brief Marks the end of a per-type list. */
+#define CMD_NONE 0xFF
+
+static_assert((uint8_t)CommandType::COUNT <= 32, "pending mask holds at most 32 command types");
+static_assert(CMD_POOL_SIZE < CMD_NONE, "pool indexes are uint8_t");
+
+/**
+ * @class CommandStore
+ * @brief Pending commands indexed by CommandType.
+ *
+ * Every type owns a FIFO list of entries taken from a shared pool, so
+ * each type only costs three bytes of RAM and the pool bounds the total.
+ * Enqueue and consume are O(1); all entries share the same TTL, so the
+ * oldest entry of a type is always the first to expire and expiry only
+ * looks at the head of the types set in the pending mask.
+ */
+class CommandStore
+{
+   private:
+    struct Entry
+    {
+        uint32_t deadline; /**< millis() after which the command is dropped */
+        uint8_t next;      /**< Next entry of the same type or of the free list */
+    };
+
+    struct TypeList
+    {
+        uint8_t head;
+        uint8_t tail;
+        uint8_t count;
+    };
+
+    Entry pool[CMD_POOL_SIZE];
+    TypeList lists[(uint8_t)CommandType::COUNT];
+    uint8_t freeHead;
+    uint32_t pending; /**< Bit t set if type t has at least one entry */
+
+    uint16_t overflows; /**< Commands rejected because the type or pool was full */
+    uint16_t expired;   /**< Commands dropped after their TTL */
+
+    /** Moves the head of a type back to the free list. */
+    void dropHead(uint8_t type);
+
+   public:
+    CommandStore();
+
+    /**
+     * @brief Appends a command after the pending ones of the same type.
+     * @param cmd Command type.
+     * @param now Current millis().
+     * @return true if stored, false if the type or the pool is full.
+     */
+    bool push(CommandType cmd, uint32_t now);
+
+    /**
+     * @brief Consumes the oldest live command of a type.
+     * @param cmd Command type.
+     * @param now Current millis(), expired entries are discarded.
+     * @return true if a command was consumed.
+     */
+    bool pop(CommandType cmd, uint32_t now);
+
+    /**
+     * @brief Discards the entries whose TTL elapsed.
+     * @param now Current millis().
+     */
+    void expire(uint32_t now);
+
+    /** @return true if at least one command of this type is pending. */
+    bool isPending(CommandType cmd) const;
+
+    /** @return uint32_t bit t set if type t has pending commands. */
+    uint32_t getPendingMask() const;
+
+    /** @return uint16_t commands rejected because the store was full. */
+    uint16_t getOverflows() const;
+
+    /** @return uint16_t commands dropped after their TTL. */
+    uint16_t getExpired() const;
+};
+
+#endif
@@ -4,13 +4,25 @@
 
 #include "Context.hpp"
 #include "config.hpp"
+#include "kernel/PerfectHash.hpp"
 
-/**
- * @brief Command name for opening the hangar door
- */
-const CommandEntry Context::commandTable[] = {{OPEN_CMD, CommandType::OPEN}};
+#define COMMAND_COUNT ((size_t)CommandType::COUNT)
 
-const int Context::COMMAND_TABLE_SIZE = sizeof(Context::commandTable) / sizeof(commandTable[0]);
+/* Names in CommandType order: constexpr copy for the generator, PROGMEM copy for the compare */
+#define COMMAND_NAME(type, name) name,
+#define COMMAND_NAME_DEF(type, name) static const char CMD_NAME_##type[] PROGMEM = name;
+#define COMMAND_NAME_REF(type, name) CMD_NAME_##type,
+
+static constexpr const char* COMMAND_NAMES[COMMAND_COUNT] = {COMMAND_CATALOG(COMMAND_NAME)};
+COMMAND_CATALOG(COMMAND_NAME_DEF)
+static const char* const COMMAND_NAMES_P[COMMAND_COUNT] PROGMEM = {COMMAND_CATALOG(COMMAND_NAME_REF)};
+
+#undef COMMAND_NAME
+#undef COMMAND_NAME_DEF
+#undef COMMAND_NAME_REF
+
+static constexpr PerfectHashTable<COMMAND_COUNT> COMMAND_HASH PROGMEM = makePerfectHash(COMMAND_NAMES);
+static_assert(COMMAND_HASH.ok, "command names collide, rename one or raise PERFECT_HASH_MAX_DISP");
 
 Context::Context()
     : openDoorRequested(false),
@@ -23,13 +35,17 @@ Context::Context()
       takeoffCheck(false),
       droneIn(true),
       pirActive(false),
+      pirReady(false),
       currentDistance(0.0f),
-      commandHead(0),
-      commandTail(0),
-      commandCount(0),
-      droneState(0)
+      temperature(0.0f),
+      doorAngle(0),
+      lcdMessage(MSG_NONE),
+      front(0),
+      droneState(0),
+      commandRxMicros(0)
 {
-    lcdMessage[0] = '\0';
+    memset(snapshots, 0, sizeof(snapshots));
+    publish();
 }
 
 // === DOOR CONTROL ===
@@ -61,6 +77,8 @@ void Context::setPreAlarm(bool active) { preAlarmActive = active; }
 bool Context::isPreAlarmActive() const { return preAlarmActive; }
 void Context::setPir(bool active) { pirActive = active; }
 bool Context::isPirActive() const { return pirActive; }
+void Context::setPirReady(bool ready) { pirReady = ready; }
+bool Context::isPirReady() const { return pirReady; }
 
 // === LED ===
 void Context::blink() { ledBlinking = true; }
@@ -68,20 +86,13 @@ void Context::stopBlink() { ledBlinking = false; }
 bool Context::isBlinking() const { return ledBlinking; }
 
 // === LCD ===
-void Context::setLCDMessage(const char* msg)
-{
-    if (!msg)
-    {
-        lcdMessage[0] = '\0';
-        return;
-    }
-    strncpy(lcdMessage, msg, LCD_BUFFER_SIZE - 1);
-    lcdMessage[LCD_BUFFER_SIZE - 1] = '\0';
-}
-const char* Context::getLCDMessage() const { return lcdMessage; }
+void Context::setLCDMessage(MessageId msg) { lcdMessage = msg; }
+MessageId Context::getLCDMessage() const { return lcdMessage; }
 
 // === DRONE & SENSORS ===
 void Context::setDistance(float d) { currentDistance = d; }
+void Context::setTemperature(float t) { temperature = t; }
+void Context::setDoorAngle(uint8_t angle) { doorAngle = angle; }
 void Context::setDroneIn(bool state) { droneIn = state; }
 bool Context::isDroneIn() const { return droneIn; }
 void Context::requestLandingCheck() { landingCheck = true; }
@@ -94,83 +105,79 @@ bool Context::takeoffCheckRequested() const { return takeoffCheck; }
 void Context::setDroneState(int s) { droneState = (int8_t)s; }
 int Context::getDroneState() const { return (int)droneState; }
 
-// === COMMAND QUEUE ===
-bool Context::enqueueCommand(CommandType cmd, uint16_t now)
+// === SNAPSHOTS ===
+void Context::publish()
 {
-    if (commandCount >= MSG_QUEUE_SIZE)
-        return false;
-    commandQueue[commandTail] = {cmd, now};
-    commandTail = (commandTail + 1) % MSG_QUEUE_SIZE;
-    commandCount++;
-    return true;
+    uint8_t f = front;
+    ContextSnapshot& back = snapshots[f ^ 1];
+    back.seq = snapshots[f].seq + 1;
+    back.alarmActive = alarmActive;
+    back.preAlarmActive = preAlarmActive;
+    back.doorOpen = doorOpen;
+    back.droneIn = droneIn;
+    back.pirActive = pirActive;
+    back.pirReady = pirReady;
+    back.blinking = ledBlinking;
+    back.droneState = droneState;
+    back.doorAngle = doorAngle;
+    back.distance = currentDistance;
+    back.temperature = temperature;
+    back.lcdMessage = lcdMessage;
+    front = f ^ 1;
 }
 
-bool Context::consumeCommand(CommandType cmd)
+const ContextSnapshot& Context::getSnapshot() const { return snapshots[front]; }
+
+// === COMMAND QUEUE ===
+bool Context::consumeCommand(CommandType cmd) { return commands.pop(cmd, millis()); }
+
+void Context::cleanupExpired(uint32_t now) { commands.expire(now); }
+
+const CommandStore& Context::getCommands() const { return commands; }
+
+void Context::stampCommand(unsigned long rxMicros) { commandRxMicros = rxMicros; }
+
+unsigned long Context::getCommandStamp() const { return commandRxMicros; }
+
+bool Context::tryEnqueueMsg(const char* msg)
 {
-    for (int i = 0; i < commandCount; i++)
-    {
-        int index = (commandHead + i) % MSG_QUEUE_SIZE;
-        if (commandQueue[index].cmd == cmd)
-        {
-            if (i != 0)
-            {
-                QueuedCommand temp = commandQueue[index];
-                commandQueue[index] = commandQueue[commandHead];
-                commandQueue[commandHead] = temp;
-            }
-            commandHead = (commandHead + 1) % MSG_QUEUE_SIZE;
-            commandCount--;
-            return true;
-        }
-    }
-    return false;
+    if (!msg)
+        return false;
+    while (*msg == ' ' || *msg == '\t') msg++;
+
+    uint8_t disp = pgm_read_byte(&COMMAND_HASH.disp[perfectHash(msg, 0) % COMMAND_COUNT]);
+    uint8_t k = pgm_read_byte(&COMMAND_HASH.key[perfectHash(msg, disp) % COMMAND_COUNT]);
+    if (strcasecmp_P(msg, (PGM_P)pgm_read_ptr(&COMMAND_NAMES_P[k])) != 0)
+        return false;
+    return enqueue((CommandType)k);
 }
 
-void Context::cleanupExpired(uint32_t now)
+bool Context::tryEnqueueCommand(uint8_t code)
 {
-    int removed = 0;
-    for (int i = 0; i < commandCount; i++)
-    {
-        int index = (commandHead + i) % MSG_QUEUE_SIZE;
-        if ((uint16_t)(now - commandQueue[index].timestamp) >= CONFIG_CMD_TTL_MS)
-        {
-            removed++;
-        }
-        else if (removed > 0)
-        {
-            commandQueue[(commandHead + i - removed) % MSG_QUEUE_SIZE] = commandQueue[index];
-        }
-    }
-    commandHead = (commandHead + removed) % MSG_QUEUE_SIZE;
-    commandCount -= removed;
+    if (code >= (uint8_t)CommandType::COUNT)
+        return false;
+    return enqueue((CommandType)code);
 }
 
-bool Context::tryEnqueueMsg(const char* msg)
+bool Context::enqueue(CommandType cmd)
 {
-    if (!msg)
+    // Kept until its TTL, a reset sent before the alarm would clear it as soon as it is raised
+    if (cmd == CommandType::RESET_ALARM && !alarmActive)
         return false;
-    while (*msg == ' ' || *msg == '\t') msg++;
-    for (int i = 0; i < COMMAND_TABLE_SIZE; i++)
-    {
-        if (strcasecmp(msg, commandTable[i].name) == 0)
-        {
-            enqueueCommand(commandTable[i].type, (uint16_t)millis());
-            return true;
-        }
-    }
-    return false;
+    return commands.push(cmd, millis());
 }
 
 void Context::serializeData(JsonDocument& doc) const
 {
+    const ContextSnapshot& snap = this->getSnapshot();
     const char* droneLabels[] = {DRONE_REST_STATE, DRONE_TAKING_OFF_STATE, DRONE_OPERATING_STATE,
                                  DRONE_LANDING_STATE};
 
-    if (this->isAlarmActive())
+    if (snap.alarmActive)
     {
         doc[HANGAR_STATE_KEY] = HANGAR_ALARM_STATE;
     }
-    else if (this->isPreAlarmActive())
+    else if (snap.preAlarmActive)
     {
         doc[HANGAR_STATE_KEY] = HANGAR_PRE_ALARM_STATE;
     }
@@ -179,10 +186,33 @@ void Context::serializeData(JsonDocument& doc) const
         doc[HANGAR_STATE_KEY] = HANGAR_NORMAL_STATE;
     }
 
-    doc[DRONE_STATE_KEY] = droneLabels[this->droneState];
+    doc[DRONE_STATE_KEY] = droneLabels[snap.droneState];
+    doc[PIR_READY_KEY] = (bool)snap.pirReady;
+
+    if (snap.distance > 0.0f)
+    {
+        doc[DISTANCE_KEY] = snap.distance;
+    }
+}
+
+void Context::serializeFrame(FrameWriter& writer) const
+{
+    const ContextSnapshot& snap = this->getSnapshot();
+    uint8_t hangar = 0;
+    if (snap.alarmActive)
+    {
+        hangar = 2;
+    }
+    else if (snap.preAlarmActive)
+    {
+        hangar = 1;
+    }
+    writer.putU8(FIELD_HANGAR, hangar);
+    writer.putU8(FIELD_DRONE, (uint8_t)snap.droneState);
+    writer.putU8(FIELD_PIR_READY, snap.pirReady);
 
-    if (this->currentDistance > 0.0f)
+    if (snap.distance > 0.0f)
     {
-        doc[DISTANCE_KEY] = this->currentDistance;
+        writer.putI16(FIELD_DISTANCE, (int16_t)(snap.distance * 1000.0f));
     }
 }
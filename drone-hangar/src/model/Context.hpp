@@ -5,79 +5,72 @@
 #include <ArduinoJson.h>
 
 #include "config.hpp"
+#include "kernel/BinaryProtocol.hpp"
 #include "kernel/CommandType.hpp"
-
-/** * @brief Max number of commands stored in the circular buffer.
- */
-#define MSG_QUEUE_SIZE 3
-
-/** * @brief Size of the LCD buffer including the null terminator.
- */
-#define LCD_BUFFER_SIZE 32
+#include "kernel/MessageCatalog.hpp"
+#include "model/CommandStore.hpp"
 
 /**
- * @struct CommandEntry
- * @brief Maps a string command name to its corresponding CommandType enum.
+ * @struct ContextSnapshot
+ * @brief Consistent copy of the state shown to the outside (telemetry, LCD).
  */
-struct CommandEntry
+struct ContextSnapshot
 {
-    const char* name;
-    CommandType type;
+    uint16_t seq;              /**< Incremented by every publish() */
+    uint8_t alarmActive : 1;
+    uint8_t preAlarmActive : 1;
+    uint8_t doorOpen : 1;
+    uint8_t droneIn : 1;
+    uint8_t pirActive : 1;
+    uint8_t pirReady : 1;
+    uint8_t blinking : 1;      /**< L2 blinks, drone taking off or landing */
+    int8_t droneState;
+    uint8_t doorAngle;
+    float distance;
+    float temperature;
+    MessageId lcdMessage;
 };
 
 /**
  * @class Context
  * @brief State Machine Context that centralizes sensor data and control logic.
- * * Uses bit-fields to minimize RAM footprint and a circular buffer for command queuing.
+ * * Uses bit-fields to minimize RAM footprint and a CommandStore for command queuing.
  */
 class Context
 {
    private:
-    // --- FLAGS (Bit-fields: 10 bits total, occupies 2 bytes instead of 10) ---
+    // --- FLAGS (Bit-fields: 11 bits total, occupies 2 bytes instead of 11) ---
     uint16_t openDoorRequested : 1;  /**< Pending request to open the door */
     uint16_t closeDoorRequested : 1; /**< Pending request to close the door */
     uint16_t doorOpen : 1;           /**< Physical state: true if door is open */
     uint16_t alarmActive : 1;        /**< Critical alarm state */
     uint16_t preAlarmActive : 1;     /**< Warning/Pre-alarm state */
-    uint16_t ledBlinking : 1;        /**< Toggle for LED blinking task */
+    uint16_t ledBlinking : 1;        /**< L2 blinking, see LedPatterns */
     uint16_t landingCheck : 1;       /**< Request for landing validation */
     uint16_t takeoffCheck : 1;       /**< Request for takeoff validation */
     uint16_t droneIn : 1;            /**< Presence of the drone inside the hangar */
     uint16_t pirActive : 1;          /**< PIR sensor detection state */
+    uint16_t pirReady : 1;           /**< PIR warm-up over */
 
     // --- SENSORS ---
     float currentDistance; /**< Distance detected by sonar sensor */
+    float temperature;     /**< Last temperature read by HangarTask */
+    uint8_t doorAngle;     /**< Current servo angle of the door */
 
-    // --- LCD BUFFER ---
-    char lcdMessage[LCD_BUFFER_SIZE]; /**< Buffer for the text displayed on the LCD */
+    // --- LCD ---
+    MessageId lcdMessage; /**< Catalog message displayed on the LCD */
+
+    // --- SNAPSHOTS ---
+    ContextSnapshot snapshots[2]; /**< Front one is read, the other is rebuilt by publish() */
+    volatile uint8_t front;       /**< Index of the front snapshot */
 
     // --- COMMAND QUEUE ---
-    /**
-     * @struct QueuedCommand
-     * @brief Internal structure for commands with TTL (Time To Live) management.
-     */
-    struct QueuedCommand
-    {
-        CommandType cmd;
-        uint16_t timestamp;
-    };
-    QueuedCommand commandQueue[MSG_QUEUE_SIZE];
-    int8_t commandHead;
-    int8_t commandTail;
-    int8_t commandCount;
+    CommandStore commands; /**< Pending commands with TTL (Time To Live) */
     int8_t droneState;
+    unsigned long commandRxMicros; /**< RX time of the last accepted command, 0 if none */
 
-    // --- COMMAND TABLE ---
-    static const CommandEntry commandTable[];
-    static const int COMMAND_TABLE_SIZE;
-
-    /**
-     * @brief Pushes a command into the circular buffer.
-     * @param cmd Command type.
-     * @param now Current timestamp in milliseconds.
-     * @return true if successful, false if queue is full.
-     */
-    bool enqueueCommand(CommandType cmd, uint16_t now);
+    /** Queues a command; RESET_ALARM is refused outside ALARM. */
+    bool enqueue(CommandType cmd);
 
    public:
     Context();
@@ -101,6 +94,8 @@ class Context
     bool isPreAlarmActive() const;
     void setPir(bool active);
     bool isPirActive() const;
+    void setPirReady(bool ready);
+    bool isPirReady() const;
     ///@}
 
     /** @name Visual Feedback */
@@ -108,13 +103,15 @@ class Context
     void blink();
     void stopBlink();
     bool isBlinking() const;
-    const char* getLCDMessage() const;
-    void setLCDMessage(const char* msg);
+    MessageId getLCDMessage() const;
+    void setLCDMessage(MessageId msg);
     ///@}
 
     /** @name Drone & Sensor Management */
     ///@{
     void setDistance(float d);
+    void setTemperature(float t);
+    void setDoorAngle(uint8_t angle);
     void setDroneIn(bool state);
     bool isDroneIn() const;
     void requestLandingCheck();
@@ -131,13 +128,26 @@ class Context
     ///@{
     /**
      * @brief Parses a string message and enqueues a command if valid.
+     *
+     * The name is found with a perfect hash and a single compare, so the
+     * cost does not grow with the number of commands. A reset is refused
+     * while no alarm is active.
      * @param msg Input string (e.g., from Serial or Network).
      * @return true if the command was recognized and queued.
      */
     bool tryEnqueueMsg(const char* msg);
 
     /**
-     * @brief Searches and consumes a specific command from the queue.
+     * @brief Enqueues a command received as a numeric code (binary protocol).
+     *
+     * Same checks as tryEnqueueMsg().
+     * @param code CommandType value.
+     * @return true if the code is valid and the command was queued.
+     */
+    bool tryEnqueueCommand(uint8_t code);
+
+    /**
+     * @brief Consumes the oldest pending command of a type, in O(1).
      * @param cmd The command type to look for.
      * @return true if found and removed.
      */
@@ -148,10 +158,45 @@ class Context
      * @param now Current uptime in milliseconds (millis()).
      */
     void cleanupExpired(uint32_t now);
+
+    /**
+     * @brief Read-only access to the command store (pending mask, statistics).
+     */
+    const CommandStore& getCommands() const;
+
+    /**
+     * @brief Records when the last accepted command was received, for latency tracing.
+     * @param rxMicros micros() timestamp of the RX path, 0 to clear it.
+     */
+    void stampCommand(unsigned long rxMicros);
+
+    /**
+     * @brief RX time of the last command not yet traced to an actuation.
+     * @return unsigned long micros() timestamp, 0 if none.
+     */
+    unsigned long getCommandStamp() const;
     ///@}
 
+    /** @name Snapshots */
+    ///@{
     /**
-     * @brief Serializes the current state into a JSON document.
+     * @brief Copies the live state into the back snapshot and makes it the front one.
+     *
+     * Tasks keep mutating the live fields; readers only see whole published
+     * states. The flip is a single byte store, so an ISR reading getSnapshot()
+     * never sees a half-written copy and no interrupt has to be disabled.
+     */
+    void publish();
+
+    /**
+     * @brief Last published state.
+     * @return const ContextSnapshot& valid until the next-but-one publish().
+     */
+    const ContextSnapshot& getSnapshot() const;
+    ///@}
+
+    /**
+     * @brief Serializes the last published state into a JSON document.
      *
      * Adds keys here to keep the API consistent. Remember to update the JSON_IN_SIZE in config.hpp
      * if needed.
@@ -159,6 +204,15 @@ class Context
      * @param doc Reference to the ArduinoJson document.
      */
     void serializeData(JsonDocument& doc) const;
+
+    /**
+     * @brief Serializes the last published state as binary protocol fields.
+     *
+     * Binary counterpart of serializeData(), keep the two in sync.
+     *
+     * @param writer Frame being built.
+     */
+    void serializeFrame(FrameWriter& writer) const;
 };
 
 #endif
@@ -0,0 +1,105 @@
+#include "model/Dashboard.hpp"
+
+struct DashFieldDef
+{
+    const char* label;
+    uint8_t row;
+    uint8_t col;
+    uint8_t width;
+    uint16_t minPeriod;
+    uint16_t deadband;
+    uint8_t format;
+};
+
+#define DASH_LABEL_DEF(id, label, row, col, width, minPeriod, deadband, format) \
+    static const char DASH_LABEL_##id[] PROGMEM = label;
+#define DASH_FIELD_DEF(id, label, row, col, width, minPeriod, deadband, format) \
+    {DASH_LABEL_##id, row, col, width, minPeriod, deadband, format},
+
+DASH_LAYOUT(DASH_LABEL_DEF)
+static const DashFieldDef DASH_FIELDS_P[DASH_FIELD_COUNT] PROGMEM = {DASH_LAYOUT(DASH_FIELD_DEF)};
+
+#undef DASH_LABEL_DEF
+#undef DASH_FIELD_DEF
+
+static_assert(DASH_FIELD_COUNT <= 8, "drawn is a byte mask");
+
+Dashboard::Dashboard() : drawn(0)
+{
+    memset(shown, 0, sizeof(shown));
+    memset(shownAt, 0, sizeof(shownAt));
+}
+
+int16_t Dashboard::valueOf(uint8_t field, const ContextSnapshot& snap)
+{
+    switch (field)
+    {
+        case DASH_TEMP:
+            return (int16_t)lround(snap.temperature * 10.0f);
+        case DASH_DISTANCE:
+            return snap.distance > 0.0f ? (int16_t)lround(snap.distance * 1000.0f) : -1;
+        case DASH_DOOR:
+            return snap.doorAngle;
+        case DASH_PIR:
+            return snap.pirReady ? 1 + snap.pirActive : 0;
+        default:
+            return snap.alarmActive ? 2 : (snap.preAlarmActive ? 1 : 0);
+    }
+}
+
+void Dashboard::format(uint8_t field, int16_t value, char* buf, uint8_t size)
+{
+    uint8_t n = strlen_P((PGM_P)pgm_read_ptr(&DASH_FIELDS_P[field].label));
+    strcpy_P(buf, (PGM_P)pgm_read_ptr(&DASH_FIELDS_P[field].label));
+    buf += n;
+    size -= n;
+
+    unsigned int v = value < 0 ? -value : value;
+    switch (pgm_read_byte(&DASH_FIELDS_P[field].format))
+    {
+        case DASH_FMT_TENTHS:
+            snprintf_P(buf, size, PSTR("%s%u.%uC"), value < 0 ? "-" : "", v / 10, v % 10);
+            break;
+        case DASH_FMT_METERS:
+            if (value < 0)
+                strncpy_P(buf, PSTR("--"), size);
+            else
+                snprintf_P(buf, size, PSTR("%u.%02um"), v / 1000, (v % 1000) / 10);
+            break;
+        case DASH_FMT_PIR:
+            strncpy_P(buf, value == 0 ? PSTR("WARM") : (value == 1 ? PSTR("NO") : PSTR("YES")), size);
+            break;
+        case DASH_FMT_HANGAR:
+            strncpy_P(buf, value == 0 ? PSTR("NORMAL") : (value == 1 ? PSTR("PRE-ALARM") : PSTR("ALARM")), size);
+            break;
+        default:
+            snprintf_P(buf, size, PSTR("%d"), value);
+            break;
+    }
+}
+
+void Dashboard::update(unsigned long now, const ContextSnapshot& snap, LCD* lcd)
+{
+    char buf[LCD_COL + 1];
+
+    for (uint8_t f = 0; f < DASH_FIELD_COUNT; f++)
+    {
+        int16_t value = valueOf(f, snap);
+        if (drawn & (1 << f))
+        {
+            if (value == shown[f] || now - shownAt[f] < pgm_read_word(&DASH_FIELDS_P[f].minPeriod))
+                continue;
+            // Presence of a value (e.g. distance) always counts as a change
+            bool appeared = (value < 0) != (shown[f] < 0);
+            if (!appeared && abs(value - shown[f]) <= (int16_t)pgm_read_word(&DASH_FIELDS_P[f].deadband))
+                continue;
+        }
+
+        format(f, value, buf, sizeof(buf));
+        lcd->put(pgm_read_byte(&DASH_FIELDS_P[f].row), pgm_read_byte(&DASH_FIELDS_P[f].col), buf,
+                 pgm_read_byte(&DASH_FIELDS_P[f].width));
+        shown[f] = value;
+        shownAt[f] = now;
+        drawn |= 1 << f;
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef __DASHBOARD__
+#define __DASHBOARD__
+
+#include <Arduino.h>
+
+#include "devices/LCD.hpp"
+#include "model/Context.hpp"
+
+/** @brief Rows at the top of the LCD left to the status message. */
+#define DASH_MESSAGE_ROWS 1
+
+/**
+ * @brief How a field value is printed.
+ */
+enum DashFormat : uint8_t
+{
+    DASH_FMT_TENTHS, /**< 0.1 units, printed as 12.3 */
+    DASH_FMT_METERS, /**< mm, printed as 1.23m, "--" if negative */
+    DASH_FMT_INT,    /**< printed as is */
+    DASH_FMT_PIR,    /**< 0 warming up, 1 nobody, 2 presence */
+    DASH_FMT_HANGAR  /**< 0 normal, 1 pre-alarm, 2 alarm */
+};
+
+/*
+ * Fields of the dashboard: X(id, label, row, col, width, minPeriod, deadband, format)
+ *
+ * A field is redrawn when its value moved by more than deadband (in the
+ * unit of the value) from the one on the glass, and not more often than
+ * once per minPeriod ms. The table is stored in flash.
+ *
+ *   0         1
+ *   01234567890123456789
+ *   DRONE INSIDE            <- status message (DASH_MESSAGE_ROWS)
+ *   T:24.5C   D:0.18m
+ *   DOOR:180  PIR:YES
+ *   HT:NORMAL
+ */
+#define DASH_LAYOUT(X)                                                      \
+    X(TEMP, "T:", 1, 0, 8, 1000, 2, DASH_FMT_TENTHS)         /* 0.1 degC */ \
+    X(DISTANCE, "D:", 1, 10, 10, 200, 10, DASH_FMT_METERS)   /* mm */       \
+    X(DOOR, "DOOR:", 2, 0, 9, 200, 2, DASH_FMT_INT)          /* degrees */  \
+    X(PIR, "PIR:", 2, 10, 10, 500, 0, DASH_FMT_PIR)                         \
+    X(HANGAR, "HT:", 3, 0, 20, 0, 0, DASH_FMT_HANGAR)
+
+#define DASH_FIELD_ENUM(id, label, row, col, width, minPeriod, deadband, format) DASH_##id,
+
+/**
+ * @brief Identifier of a dashboard field.
+ */
+enum DashField : uint8_t
+{
+    DASH_LAYOUT(DASH_FIELD_ENUM) DASH_FIELD_COUNT
+};
+
+#undef DASH_FIELD_ENUM
+
+/**
+ * @brief Live fields of the LCD, bound to the Context snapshot.
+ *
+ * Only the regions whose value changed enough are laid out again, and the
+ * LCD shadow buffer then writes only the cells that differ.
+ */
+class Dashboard
+{
+   private:
+    int16_t shown[DASH_FIELD_COUNT];         /**< Value on the glass */
+    unsigned long shownAt[DASH_FIELD_COUNT]; /**< millis() it was laid out */
+    uint8_t drawn;                           /**< Bit f set once field f is on the glass */
+
+    static int16_t valueOf(uint8_t field, const ContextSnapshot& snap);
+    static void format(uint8_t field, int16_t value, char* buf, uint8_t size);
+
+   public:
+    Dashboard();
+
+    /**
+     * @brief Lay out the fields that are due and changed enough.
+     *
+     * @param now Current millis().
+     * @param snap State to show.
+     * @param lcd Display, flushed by the caller.
+     */
+    void update(unsigned long now, const ContextSnapshot& snap, LCD* lcd);
+};
+
+#endif
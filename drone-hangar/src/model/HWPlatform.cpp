@@ -5,46 +5,46 @@
 #include "config.hpp"
 #include "devices/ButtonImpl.hpp"
 #include "devices/LCD.hpp"
-#include "devices/Led.hpp"
 #include "devices/Pir.hpp"
 #include "devices/ServoMotorImpl.hpp"
 #include "devices/Sonar.hpp"
 #include "devices/TempSensorTMP36.hpp"
+#include "kernel/BootProfile.hpp"
 #include "kernel/Logger.hpp"
 #include "kernel/MsgService.hpp"
+#include "model/LedPatterns.hpp"
 
 #define MAX_TIME 30000
 
-void wakeUp() {}
-
+// The native build takes its devices from sim/SimPlatform.cpp
+#ifndef ARDUINO_SIM
 HWPlatform::HWPlatform() : pir(DPD_PIN)
 {
     this->button = new ButtonImpl(RESET_PIN);
-    this->l1 = new Led(L1_PIN);
-    this->l2 = new Led(L2_PIN);
-    this->l3 = new Led(L3_PIN);
-    this->lcd = new LCD(LCD_ADR, LCD_COL, LCD_ROW);
     this->motor = new ServoMotorImpl(HD_PIN);
     this->tempSensor = new TempSensorTMP36(TEMP_PIN);
     this->proximitySensor = new Sonar(DDD_PIN_E, DDD_PIN_T, MAX_TIME);
     this->presenceSensor = &pir;
+    BootProfile.mark(BOOT_DEVICES);
+
+    this->lcd = new LCD(LCD_ADR, LCD_COL, LCD_ROW);
+    BootProfile.mark(BOOT_LCD);
 }
 
 void HWPlatform::init()
 {
     motor->on();
-    Logger.log(F("Calibrating PIR..."));
+    BootProfile.mark(BOOT_SERVO);
+
+    // The warm-up goes on while the tasks run, see AcquisitionTask
+    Logger.log(LOG_PIR_CALIBRATING);
     pir.calibrate();
+    BootProfile.mark(BOOT_PIR);
 }
+#endif
 
 Button* HWPlatform::getButton() { return this->button; }
 
-Light* HWPlatform::getL1() { return this->l1; }
-
-Light* HWPlatform::getL2() { return this->l2; }
-
-Light* HWPlatform::getL3() { return this->l3; }
-
 ServoMotor* HWPlatform::getMotor() { return this->motor; }
 
 TempSensor* HWPlatform::getTempSensor() { return this->tempSensor; }
@@ -70,11 +70,11 @@ void HWPlatform::test()
         case 0:
             Logger.log(F("=== HW TEST START ==="));
             lcd->clear();
-            lcd->print("HW TEST START");
+            lcd->print(MSG_TEST_START);
 
-            l1->switchOff();
-            l2->switchOff();
-            l3->switchOff();
+            LedPatterns.show(LED_L1, LED_OFF);
+            LedPatterns.show(LED_L2, LED_OFF);
+            LedPatterns.show(LED_L3, LED_OFF);
             motor->off();
 
             step++;
@@ -87,24 +87,24 @@ void HWPlatform::test()
                 subStep++;
                 if (subStep == 1)
                 {
-                    l1->switchOn();
+                    LedPatterns.show(LED_L1, LED_SOLID);
                     Logger.log(F("[TEST] L1 ON"));
                 }
                 else if (subStep == 2)
                 {
-                    l1->switchOff();
-                    l2->switchOn();
+                    LedPatterns.show(LED_L1, LED_OFF);
+                    LedPatterns.show(LED_L2, LED_SOLID);
                     Logger.log(F("[TEST] L2 ON"));
                 }
                 else if (subStep == 3)
                 {
-                    l2->switchOff();
-                    l3->switchOn();
+                    LedPatterns.show(LED_L2, LED_OFF);
+                    LedPatterns.show(LED_L3, LED_SOLID);
                     Logger.log(F("[TEST] L3 ON"));
                 }
                 else if (subStep == 4)
                 {
-                    l3->switchOff();
+                    LedPatterns.show(LED_L3, LED_OFF);
                     Logger.log(F("[TEST] LEDs OFF"));
                     step++;
                     subStep = 0;
@@ -144,7 +144,7 @@ void HWPlatform::test()
             {
                 Logger.log(F("=== SENSOR MONITOR (10s) ==="));
                 lcd->clear();
-                lcd->print("SENSORS TEST...");
+                lcd->print(MSG_TEST_SENSORS);
                 subStep = 1;
                 lastStepTime = now;
             }
@@ -180,7 +180,7 @@ void HWPlatform::test()
         case 4:
             Logger.log(F("=== TEST COMPLETE ==="));
             lcd->clear();
-            lcd->print("TEST DONE");
+            lcd->print(MSG_TEST_DONE);
             step = 0;
             subStep = 0;
             lastStepTime = now;
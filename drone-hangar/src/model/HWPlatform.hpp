@@ -4,7 +4,6 @@
 #include "config.hpp"
 #include "devices/Button.hpp"
 #include "devices/LCD.hpp"
-#include "devices/Led.hpp"
 #include "devices/Pir.hpp"
 #include "devices/PresenceSensor.hpp"
 #include "devices/ProximitySensor.hpp"
@@ -19,9 +18,6 @@ class HWPlatform
 {
    private:
     Button* button;
-    Light* l1;
-    Light* l2;
-    Light* l3;
     PresenceSensor* presenceSensor;
     ServoMotor* motor;
     TempSensor* tempSensor;
@@ -43,7 +39,8 @@ class HWPlatform
     void init();
 
     /**
-     * @brief Run hardware tests.
+     * @brief Run hardware tests. The LEDs are shown through LedPatterns,
+     * which must be attached.
      *
      */
     void test();
@@ -55,27 +52,6 @@ class HWPlatform
      */
     Button* getButton();
 
-    /**
-     * @brief Get the L1 Light object
-     *
-     * @return Light* pointer to the L1 Light
-     */
-    Light* getL1();
-
-    /**
-     * @brief Get the L2 Light object
-     *
-     * @return Light* pointer to the L2 Light
-     */
-    Light* getL2();
-
-    /**
-     * @brief Get the L3 Light object
-     *
-     * @return Light* pointer to the L3 Light
-     */
-    Light* getL3();
-
     /**
      * @brief Get the Motor object
      *
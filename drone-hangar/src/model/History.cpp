@@ -0,0 +1,167 @@
+#include "model/History.hpp"
+
+/* First slot, length and number of finer buckets per bucket, for each level */
+static const uint8_t LEVEL_OFFSET[HIST_LEVELS] PROGMEM = {0, HISTORY_LEN_1S, HISTORY_LEN_1S + HISTORY_LEN_10S};
+static const uint8_t LEVEL_LEN[HIST_LEVELS] PROGMEM = {HISTORY_LEN_1S, HISTORY_LEN_10S, HISTORY_LEN_1MIN};
+static const uint8_t LEVEL_FACTOR[HIST_LEVELS] PROGMEM = {1, 10, 6};
+
+static const char SIGNAL_TEMPERATURE[] PROGMEM = "temp";
+static const char SIGNAL_DISTANCE[] PROGMEM = "distance";
+static const char SIGNAL_DOOR[] PROGMEM = "door";
+static const char* const SIGNAL_NAMES[HIST_SIGNALS] PROGMEM = {SIGNAL_TEMPERATURE, SIGNAL_DISTANCE, SIGNAL_DOOR};
+
+static_assert(HISTORY_BUCKETS < 256, "bucket slots are uint8_t");
+static_assert(sizeof(HistoryStore) <= HISTORY_RAM_BUDGET, "history over its RAM budget, shorten a level");
+
+HistoryStore History;
+
+static uint8_t clampQ(long q) { return q < 0 ? 0 : (q >= HIST_NO_READING ? HIST_NO_READING - 1 : (uint8_t)q); }
+
+/*
+ * Quantization, one byte per value, HIST_NO_READING reserved:
+ *   temperature: 0.5 degC steps from -20 degC   distance: 20 mm steps
+ *   door: degrees
+ */
+static uint8_t quantize(uint8_t signal, const ContextSnapshot& snap)
+{
+    switch (signal)
+    {
+        case HIST_TEMPERATURE:
+            return clampQ(lround(snap.temperature * 2.0f) + 40);
+        case HIST_DISTANCE:
+            return snap.distance < 0 ? HIST_NO_READING : clampQ(lround(snap.distance * 50.0f));
+        default:
+            return snap.doorAngle;
+    }
+}
+
+static int16_t dequantize(uint8_t signal, uint8_t q)
+{
+    if (q == HIST_NO_READING)
+        return -1;
+    switch (signal)
+    {
+        case HIST_TEMPERATURE:
+            return (int16_t)q * 5 - 200;
+        case HIST_DISTANCE:
+            return (int16_t)q * 20;
+        default:
+            return q;
+    }
+}
+
+HistoryStore::HistoryStore() : bucketStart(0)
+{
+    memset(acc, 0, sizeof(acc));
+    memset(head, 0, sizeof(head));
+    memset(count, 0, sizeof(count));
+    memset(closed, 0, sizeof(closed));
+    memset(folded, 0, sizeof(folded));
+}
+
+void HistoryStore::fold(uint8_t signal, uint8_t level, uint8_t min, uint8_t max, uint8_t avg)
+{
+    // A gap does not pull the min or the average down, it only shows if the whole bucket is one
+    if (avg == HIST_NO_READING)
+        return;
+    Accumulator& a = acc[signal][level];
+    if (a.n == 0 || min < a.min)
+        a.min = min;
+    if (a.n == 0 || max > a.max)
+        a.max = max;
+    a.sum += avg;
+    a.n++;
+}
+
+void HistoryStore::close(uint8_t level)
+{
+    if (folded[level] == 0)
+        return;
+
+    uint8_t len = pgm_read_byte(&LEVEL_LEN[level]);
+    uint8_t slot = pgm_read_byte(&LEVEL_OFFSET[level]) + head[level];
+    for (uint8_t s = 0; s < HIST_SIGNALS; s++)
+    {
+        Accumulator& a = acc[s][level];
+        HistoryBucket& b = buckets[s][slot];
+        if (a.n == 0)
+        {
+            b.min = b.max = b.avg = HIST_NO_READING;
+        }
+        else
+        {
+            b.min = a.min;
+            b.max = a.max;
+            b.avg = (uint8_t)((a.sum + a.n / 2) / a.n);
+        }
+        a.sum = 0;
+        a.n = 0;
+        if (level + 1 < HIST_LEVELS)
+            fold(s, level + 1, b.min, b.max, b.avg);
+    }
+    head[level] = (head[level] + 1) % len;
+    if (count[level] < len)
+        count[level]++;
+    closed[level]++;
+    folded[level] = 0;
+
+    if (level + 1 < HIST_LEVELS && ++folded[level + 1] >= pgm_read_byte(&LEVEL_FACTOR[level + 1]))
+        close(level + 1);
+}
+
+void HistoryStore::sample(unsigned long now, const ContextSnapshot& snap)
+{
+    if (now - bucketStart >= HISTORY_BASE_MS)
+    {
+        close(HIST_1S);
+        // Keep buckets aligned unless samples stopped for a while
+        bucketStart = (now - bucketStart >= 2 * HISTORY_BASE_MS) ? now : bucketStart + HISTORY_BASE_MS;
+    }
+
+    for (uint8_t s = 0; s < HIST_SIGNALS; s++)
+    {
+        uint8_t q = quantize(s, snap);
+        fold(s, HIST_1S, q, q, q);
+    }
+    if (folded[HIST_1S] < 0xFF)
+        folded[HIST_1S]++;
+}
+
+uint8_t HistoryStore::size(HistoryLevel level) const { return level < HIST_LEVELS ? count[level] : 0; }
+
+HistoryMark HistoryStore::mark(HistoryLevel level) const
+{
+    if (level >= HIST_LEVELS)
+        return {HIST_LEVELS, 0, 0, 0};
+    return {level, head[level], count[level], closed[level]};
+}
+
+bool HistoryStore::read(HistorySignal signal, const HistoryMark& at, uint8_t index, int16_t& min, int16_t& max,
+                        int16_t& avg) const
+{
+    if (signal >= HIST_SIGNALS || at.level >= HIST_LEVELS || index >= at.count)
+        return false;
+
+    // Every bucket closed since the mark took the slot of the oldest one left
+    uint8_t len = pgm_read_byte(&LEVEL_LEN[at.level]);
+    uint8_t since = closed[at.level] - at.closed;
+    if (since >= len || index >= len - since)
+        return false;
+
+    uint8_t slot = pgm_read_byte(&LEVEL_OFFSET[at.level]) + (at.head + len - 1 - index) % len;
+    const HistoryBucket& b = buckets[signal][slot];
+    min = dequantize(signal, b.min);
+    max = dequantize(signal, b.max);
+    avg = dequantize(signal, b.avg);
+    return true;
+}
+
+HistorySignal HistoryStore::signalFromName(const char* name) const
+{
+    for (uint8_t s = 0; s < HIST_SIGNALS; s++)
+    {
+        if (strcasecmp_P(name, (PGM_P)pgm_read_ptr(&SIGNAL_NAMES[s])) == 0)
+            return (HistorySignal)s;
+    }
+    return HIST_SIGNALS;
+}
@@ -0,0 +1,151 @@
+#ifndef __HISTORY__
+#define __HISTORY__
+
+#include <Arduino.h>
+
+#include "model/Context.hpp"
+
+/*
+ * Multi-resolution history of a few signals.
+ *
+ * Samples are folded into a 1 s bucket; each closed bucket is folded into
+ * the 10 s one and so on, so a sample costs O(1) whatever the window. A
+ * bucket keeps min/max/avg quantized to one byte (see History.cpp for the
+ * scale of each signal); HIST_NO_READING marks a bucket without any valid
+ * sample, e.g. the sonar without an echo. Every size is a compile-time
+ * constant, checked against HISTORY_RAM_BUDGET:
+ *
+ *   RAM = HIST_SIGNALS * (3 * HISTORY_BUCKETS + 5 * HIST_LEVELS) + 4 * HIST_LEVELS + 4
+ *
+ * The alarm level is not recorded: the journal keeps every hangar state
+ * change with its time.
+ */
+
+/** @brief Duration of a bucket of the finest level. */
+#define HISTORY_BASE_MS 1000
+
+/** @brief Buckets kept per level: 4 x 1 s, 6 x 10 s, 10 x 1 min. */
+#define HISTORY_LEN_1S 4
+#define HISTORY_LEN_10S 6
+#define HISTORY_LEN_1MIN 10
+
+#define HISTORY_BUCKETS (HISTORY_LEN_1S + HISTORY_LEN_10S + HISTORY_LEN_1MIN)
+
+/** @brief Most RAM the store may take (241 B on the Uno with the defaults). */
+#define HISTORY_RAM_BUDGET 256
+
+/** @brief Quantized value of a sample or a bucket without a reading. */
+#define HIST_NO_READING 0xFF
+
+/**
+ * @brief Recorded signals.
+ */
+enum HistorySignal : uint8_t
+{
+    HIST_TEMPERATURE, /**< 0.1 degC */
+    HIST_DISTANCE,    /**< mm, -1 without an echo */
+    HIST_DOOR,        /**< degrees */
+    HIST_SIGNALS
+};
+
+/**
+ * @brief Resolutions, finest first.
+ */
+enum HistoryLevel : uint8_t
+{
+    HIST_1S,
+    HIST_10S,
+    HIST_1MIN,
+    HIST_LEVELS
+};
+
+/**
+ * @brief One closed bucket, quantized.
+ */
+struct HistoryBucket
+{
+    uint8_t min;
+    uint8_t max;
+    uint8_t avg;
+};
+
+/**
+ * @brief Position of a level when a query started, see HistoryStore::mark().
+ */
+struct HistoryMark
+{
+    uint8_t level;
+    uint8_t head;   /**< Slot of the next bucket */
+    uint8_t count;  /**< Closed buckets */
+    uint8_t closed; /**< Buckets closed so far, modulo 256 */
+};
+
+/**
+ * @brief Ring buffers of min/max/avg buckets at several resolutions.
+ */
+class HistoryStore
+{
+   private:
+    struct Accumulator
+    {
+        uint8_t min;
+        uint8_t max;
+        uint16_t sum;
+        uint8_t n;
+    };
+
+    HistoryBucket buckets[HIST_SIGNALS][HISTORY_BUCKETS];
+    Accumulator acc[HIST_SIGNALS][HIST_LEVELS];
+    uint8_t head[HIST_LEVELS];   /**< Slot of the next bucket of each level */
+    uint8_t count[HIST_LEVELS];  /**< Closed buckets available per level */
+    uint8_t closed[HIST_LEVELS]; /**< Buckets closed per level, modulo 256 */
+    uint8_t folded[HIST_LEVELS]; /**< Samples or finer buckets in the open bucket */
+    unsigned long bucketStart;
+
+    void fold(uint8_t signal, uint8_t level, uint8_t min, uint8_t max, uint8_t avg);
+    void close(uint8_t level);
+
+   public:
+    HistoryStore();
+
+    /**
+     * @brief Add one sample of every signal, O(1).
+     *
+     * @param now Current millis().
+     * @param snap State to sample.
+     */
+    void sample(unsigned long now, const ContextSnapshot& snap);
+
+    /**
+     * @brief Number of closed buckets of a level.
+     */
+    uint8_t size(HistoryLevel level) const;
+
+    /**
+     * @brief Current position of a level, to read it while buckets close.
+     */
+    HistoryMark mark(HistoryLevel level) const;
+
+    /**
+     * @brief Read a closed bucket, 0 being the newest one at the mark.
+     *
+     * Values are converted back to the unit of the signal, -1 for a
+     * distance bucket without any echo.
+     *
+     * @return true if the bucket existed at the mark and has not been
+     * overwritten since.
+     */
+    bool read(HistorySignal signal, const HistoryMark& at, uint8_t index, int16_t& min, int16_t& max,
+              int16_t& avg) const;
+
+    /**
+     * @brief Look up a signal by name ("temp", "distance", "door").
+     *
+     * @return HistorySignal the signal, HIST_SIGNALS if unknown.
+     */
+    HistorySignal signalFromName(const char* name) const;
+};
+
+extern HistoryStore History;
+
+#endif
@@ -0,0 +1,218 @@
+#include "model/LedPatterns.hpp"
+
+#include <avr/interrupt.h>
+
+#include "kernel/Params.hpp"
+
+struct LedPatternDef
+{
+    uint8_t pulses;
+    uint16_t onMs;
+    uint16_t offMs;
+    uint16_t periodMs;
+    bool fade;
+};
+
+#define LED_PATTERN_DEF(id, pulses, onMs, offMs, periodMs, fade) {pulses, onMs, offMs, periodMs, fade},
+
+static const LedPatternDef LED_PATTERNS_P[LED_PATTERN_COUNT] PROGMEM = {LED_PATTERN_CATALOG(LED_PATTERN_DEF)};
+
+#undef LED_PATTERN_DEF
+
+/* round(255 * (i / 31)^2.2): equal steps look equally bright */
+static const uint8_t LED_GAMMA_P[LED_GAMMA_STEPS] PROGMEM = {
+    0,  0,  1,  1,  3,  5,  7,   10,  13,  17,  21,  26,  32,  38,  44,  52,
+    60, 68, 77, 87, 97, 108, 120, 132, 145, 159, 173, 188, 204, 220, 237, 255};
+
+LedPatternEngine LedPatterns;
+
+#define LED_PATTERN_FITS(id, pulses, onMs, offMs, periodMs, fade) &&(2 * (pulses) + 1 <= LED_MAX_SEGMENTS)
+static_assert(true LED_PATTERN_CATALOG(LED_PATTERN_FITS), "a pattern has more segments than LED_MAX_SEGMENTS");
+#undef LED_PATTERN_FITS
+
+/* Timer0 compare A fires every 256 * 64 / 16 MHz = 1.024 ms */
+static uint16_t ticksOf(uint16_t ms)
+{
+    if (ms == LED_BLINK_MS)
+        ms = Params.get(PARAM_BLINK_PERIOD);
+    uint16_t t = (uint32_t)ms * 125 / 128;
+    return (ms != 0 && t == 0) ? 1 : t;
+}
+
+LedPatternEngine::LedPatternEngine() { memset(channels, 0, sizeof(channels)); }
+
+void LedPatternEngine::attach(LedId led, uint8_t pin)
+{
+    Channel& c = channels[led];
+    pinMode(pin, OUTPUT);
+    c.mask = digitalPinToBitMask(pin);
+    // Timer1 runs the scheduler, Timer2 the servo and OCR0A the engine: only OC0B is left
+    c.ocr = digitalPinToTimer(pin) == TIMER0B ? &OCR0B : nullptr;
+    c.pattern = LED_OFF;
+    c.level = 0;
+    noInterrupts();
+    c.port = portOutputRegister(digitalPinToPort(pin));
+    *c.port &= ~c.mask;
+    interrupts();
+}
+
+void LedPatternEngine::init()
+{
+    // Just before the millis() overflow, so both share the idle wake-up
+    OCR0A = 0xFF;
+    TIMSK0 |= _BV(OCIE0A);
+}
+
+/*
+ * L1: system on.
+ * L2: blinks during take-off and landing, breathes while the PIR warms up.
+ * L3: on in alarm, double blink in pre-alarm.
+ */
+LedPatternId LedPatternEngine::patternFor(uint8_t led, const ContextSnapshot& snap)
+{
+    switch (led)
+    {
+        case LED_L1:
+            return LED_SOLID;
+        case LED_L2:
+            return snap.blinking ? LED_BLINK : (snap.pirReady ? LED_OFF : LED_FADE);
+        default:
+            return snap.alarmActive ? LED_SOLID : (snap.preAlarmActive ? LED_DOUBLE_BLINK : LED_OFF);
+    }
+}
+
+void LedPatternEngine::build(const Channel& c, LedPatternId pattern, Program& program)
+{
+    memset(&program, 0, sizeof(program));
+    const LedPatternDef* def = &LED_PATTERNS_P[pattern];
+    uint16_t period = ticksOf(pgm_read_word(&def->periodMs));
+
+    if (pgm_read_byte(&def->fade))
+    {
+        const uint8_t top = LED_GAMMA_STEPS - 1;
+        if (c.ocr == nullptr)
+        {
+            program.level[0] = 255;  // no PWM on the pin: lit
+            return;
+        }
+        program.fade = true;
+        program.count = 2 * top;
+        program.len[0] = period / (2 * top);
+        if (program.len[0] == 0)
+            program.len[0] = 1;
+        return;
+    }
+
+    uint8_t pulses = pgm_read_byte(&def->pulses);
+    uint16_t on = ticksOf(pgm_read_word(&def->onMs));
+    uint16_t off = ticksOf(pgm_read_word(&def->offMs));
+    uint32_t used = (uint32_t)pulses * (on + off);
+    uint16_t rest = period > used ? period - used : 0;
+
+    // Empty segments are left out, the interrupt never meets one
+    for (uint8_t seg = 0; seg <= 2 * pulses; seg++)
+    {
+        uint16_t len = seg == 2 * pulses ? rest : ((seg & 1) ? off : on);
+        if (len == 0)
+            continue;
+        program.len[program.count] = len;
+        program.level[program.count] = (seg & 1) || seg == 2 * pulses ? 0 : 255;
+        program.count++;
+    }
+    if (program.count <= 1)
+        program.count = 0;  // one level for good (dark if no segment lasts)
+}
+
+void LedPatternEngine::update(const ContextSnapshot& snap)
+{
+    for (uint8_t i = 0; i < LED_COUNT; i++)
+    {
+        Channel& c = channels[i];
+        if (c.port == nullptr)
+            continue;
+        LedPatternId pattern = patternFor(i, snap);
+        Program program;
+        build(c, pattern, program);
+
+        // A new pattern starts over, a new blink_period keeps the segment running
+        bool restart = pattern != c.pattern || (program.count != 0 && c.seg >= program.count);
+        if (!restart && memcmp(&program, &c.program, sizeof(program)) == 0)
+            continue;
+        noInterrupts();
+        c.program = program;
+        if (restart)
+        {
+            c.pattern = pattern;
+            c.seg = 0;
+            enter(c);
+        }
+        interrupts();
+    }
+}
+
+void LedPatternEngine::show(LedId led, LedPatternId pattern)
+{
+    Channel& c = channels[led];
+    if (c.port == nullptr)
+        return;
+    Program program;
+    build(c, pattern, program);
+    noInterrupts();
+    c.program = program;
+    c.pattern = pattern;
+    c.seg = 0;
+    enter(c);
+    interrupts();
+}
+
+void LedPatternEngine::enter(Channel& c)
+{
+    const Program& p = c.program;
+    if (p.fade)
+    {
+        const uint8_t top = LED_GAMMA_STEPS - 1;
+        uint8_t step = c.seg <= top ? c.seg : 2 * top - c.seg;
+        output(c, pgm_read_byte(&LED_GAMMA_P[step]));
+        c.left = p.len[0];
+    }
+    else
+    {
+        output(c, p.level[c.seg]);
+        c.left = p.count == 0 ? 0 : p.len[c.seg];
+    }
+}
+
+void LedPatternEngine::output(Channel& c, uint8_t level)
+{
+    if (level == c.level)
+        return;
+    c.level = level;
+    if (c.ocr != nullptr && level != 0 && level != 255)
+    {
+        *c.ocr = level;
+        TCCR0A |= _BV(COM0B1);  // the pin follows the compare match
+        return;
+    }
+    if (c.ocr != nullptr)
+        TCCR0A &= ~_BV(COM0B1);  // back to the port, no 1/256 glitch at 0
+    if (level)
+        *c.port |= c.mask;
+    else
+        *c.port &= ~c.mask;
+}
+
+void LedPatternEngine::tick()
+{
+    for (uint8_t i = 0; i < LED_COUNT; i++)
+    {
+        Channel& c = channels[i];
+        if (c.left != 0 && --c.left == 0)
+        {
+            if (++c.seg >= c.program.count)
+                c.seg = 0;
+            enter(c);
+        }
+    }
+}
+
+ISR(TIMER0_COMPA_vect) { LedPatterns.tick(); }
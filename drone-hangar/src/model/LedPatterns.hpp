@@ -0,0 +1,139 @@
+#ifndef __LED_PATTERNS__
+#define __LED_PATTERNS__
+
+#include <Arduino.h>
+
+#include "model/Context.hpp"
+
+/** @brief Stands for the blink_period parameter in a pattern. */
+#define LED_BLINK_MS 0xFFFF
+
+/** @brief Levels of the gamma table, from dark to full brightness. */
+#define LED_GAMMA_STEPS 32
+
+/*
+ * LED patterns: X(id, pulses, onMs, offMs, periodMs, fade)
+ *
+ * A pattern repeats every periodMs: pulses times onMs lit and offMs dark,
+ * then dark for the rest of the period (periodMs 0: no rest). A fade
+ * pattern breathes instead, up and down the gamma table once per period,
+ * and needs a LED on a PWM pin. The table is stored in flash.
+ */
+#define LED_PATTERN_CATALOG(X)                                 \
+    X(OFF, 0, 0, 0, 0, false)                                  \
+    X(SOLID, 1, 1000, 0, 0, false)                             \
+    X(BLINK, 1, LED_BLINK_MS, LED_BLINK_MS, 0, false)          \
+    X(DOUBLE_BLINK, 2, 100, 150, 1000, false)                  \
+    X(FADE, 0, 0, 0, 2000, true)
+
+#define LED_PATTERN_ENUM(id, pulses, onMs, offMs, periodMs, fade) LED_##id,
+
+/**
+ * @brief Identifier of a LED pattern.
+ */
+enum LedPatternId : uint8_t
+{
+    LED_PATTERN_CATALOG(LED_PATTERN_ENUM) LED_PATTERN_COUNT
+};
+
+#undef LED_PATTERN_ENUM
+
+/**
+ * @brief LEDs driven by the engine.
+ */
+enum LedId : uint8_t
+{
+    LED_L1, /**< Green, system on */
+    LED_L2, /**< Green, in action */
+    LED_L3, /**< Red, alarm */
+    LED_COUNT
+};
+
+/** @brief Segments of a prepared on/off pattern: two per pulse and the rest. */
+#define LED_MAX_SEGMENTS 5
+
+/**
+ * @brief Drives the LEDs from the Timer0 compare A interrupt.
+ *
+ * Timer0 already runs millis(), its compare A match fires once per
+ * overflow (1.024 ms) and is otherwise unused. The pattern of each LED is
+ * chosen in task context, from each published Context snapshot, and
+ * prepared there: segment lengths in ticks and levels, with blink_period
+ * read. On each tick the interrupt only counts down the segment of each
+ * LED and writes the port (or the PWM compare register) of the pin when
+ * a segment ends, so the blink timing does not depend on the scheduler
+ * and takes no task slot.
+ */
+class LedPatternEngine
+{
+   private:
+    /** Segments of one round of a pattern, ready for the interrupt. */
+    struct Program
+    {
+        uint16_t len[LED_MAX_SEGMENTS];  /**< Ticks of each segment, none is 0 */
+        uint8_t level[LED_MAX_SEGMENTS]; /**< Level of each segment, 0 to 255 */
+        uint8_t count;                   /**< Segments per round, 0 holds level[0] */
+        bool fade;                       /**< count gamma steps up and down, each len[0] long */
+    };
+
+    struct Channel
+    {
+        volatile uint8_t* port; /**< Output register of the pin, nullptr if not attached */
+        uint8_t mask;           /**< Bit of the pin in port */
+        volatile uint8_t* ocr;  /**< PWM compare register of the pin, nullptr without PWM */
+        LedPatternId pattern;   /**< Pattern of program */
+        Program program;
+        uint8_t seg;   /**< Segment of the program, or fade step */
+        uint16_t left; /**< Ticks left in the segment, 0 holds it */
+        uint8_t level; /**< Level on the pin, 0 to 255 */
+    };
+    Channel channels[LED_COUNT];
+
+    static LedPatternId patternFor(uint8_t led, const ContextSnapshot& snap);
+    static void build(const Channel& c, LedPatternId pattern, Program& program);
+    static void enter(Channel& c);
+    static void output(Channel& c, uint8_t level);
+
+   public:
+    LedPatternEngine();
+
+    /**
+     * @brief Drive the LED on a pin. Fades need the Timer0 B PWM pin (5),
+     * other pins are only switched.
+     */
+    void attach(LedId led, uint8_t pin);
+
+    /**
+     * @brief Start the timer interrupt, after the LEDs are attached.
+     */
+    void init();
+
+    /**
+     * @brief Choose and prepare the patterns, in task context.
+     *
+     * A new pattern starts from its first segment. A new blink_period
+     * applies from the next segment.
+     *
+     * @param snap Snapshot the patterns follow.
+     */
+    void update(const ContextSnapshot& snap);
+
+    /**
+     * @brief Show a pattern on one LED, in task context, until the next
+     * update(). The hardware test drives the LEDs with it, since no
+     * snapshot is published then.
+     *
+     * @param led LED to drive.
+     * @param pattern Pattern, started from its first segment.
+     */
+    void show(LedId led, LedPatternId pattern);
+
+    /**
+     * @brief One engine step, from the timer interrupt.
+     */
+    void tick();
+};
+
+extern LedPatternEngine LedPatterns;
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __SENSOR_READINGS__
+#define __SENSOR_READINGS__
+
+#include <stdint.h>
+
+/**
+ * @brief Latest value of every input device, with the millis() it was
+ * sampled at (edge time for the interrupt-driven inputs).
+ *
+ * Written only by AcquisitionTask at the start of a slot, read by the
+ * tasks instead of the devices. Presses are counters: a task compares
+ * them with the value it saw last, so a press is seen once by each task
+ * whatever its period.
+ */
+struct SensorReadings
+{
+    bool buttonDown;
+    uint8_t buttonPresses;  /**< Debounced presses, wraps around */
+    unsigned long buttonAt; /**< Last button edge */
+
+    bool presence;
+    bool pirReady;            /**< false during the PIR warm-up, presence is meaningless */
+    unsigned long presenceAt; /**< Last PIR edge */
+
+    float temperature; /**< degC */
+    unsigned long temperatureAt;
+
+    float distance;   /**< m */
+    bool hasDistance; /**< false while no landing/takeoff check is running */
+    unsigned long distanceAt;
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdio.h>
+
+#include "sim/SimArduino.hpp"
+#include "sim/SimClock.hpp"
+
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+volatile uint8_t TCCR0A, TCNT0, OCR0A, OCR0B, TIMSK0;
+volatile uint8_t PINB, PINC, PIND, PORTB, PORTC, PORTD;
+volatile uint8_t PCICR, PCIFR, PCMSK0, EIMSK, SREG;
+
+/* ===== Time ===== */
+
+unsigned long millis()
+{
+    SimClock.advance(SIM_CALL_US);
+    return (unsigned long)(SimClock.nowUs() / 1000);
+}
+
+unsigned long micros()
+{
+    SimClock.advance(SIM_CALL_US);
+    return (unsigned long)SimClock.nowUs();
+}
+
+void delay(unsigned long ms) { SimClock.advance((uint64_t)ms * 1000); }
+
+void delayMicroseconds(unsigned int us) { SimClock.advance(us); }
+
+/* ===== Pins ===== */
+
+static int pinLevels[NUM_DIGITAL_PINS];
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+        return;
+    pinLevels[pin] = val ? HIGH : LOW;
+    if (digitalPinToTimer(pin) == TIMER0B)
+        TCCR0A &= ~_BV(COM0B1);  // the port drives the pin again
+    volatile uint8_t* port = portOutputRegister(digitalPinToPort(pin));
+    if (val)
+        *port |= digitalPinToBitMask(pin);
+    else
+        *port &= ~digitalPinToBitMask(pin);
+}
+
+int digitalRead(uint8_t pin) { return pin < NUM_DIGITAL_PINS && pinLevels[pin] ? HIGH : LOW; }
+
+int analogRead(uint8_t)
+{
+    SimClock.advance(112);  // one conversion
+    return 0;
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+        return;
+    if (digitalPinToTimer(pin) != TIMER0B || val <= 0 || val >= 255)
+    {
+        digitalWrite(pin, val >= 128 ? HIGH : LOW);  // as the AVR core, no PWM on the pin
+        pinLevels[pin] = val;
+        return;
+    }
+    pinLevels[pin] = val;
+    OCR0B = val;
+    TCCR0A |= _BV(COM0B1);
+}
+
+unsigned long pulseIn(uint8_t, uint8_t, unsigned long timeout)
+{
+    SimClock.advance(timeout);  // nothing wired: no echo
+    return 0;
+}
+
+int simPinLevel(uint8_t pin) { return pin < NUM_DIGITAL_PINS ? pinLevels[pin] : 0; }
+
+// No pin edges: the simulated PIR and button queue their events themselves
+void attachInterrupt(uint8_t, void (*)(), int) {}
+
+void detachInterrupt(uint8_t) {}
+
+/* ===== Strings ===== */
+
+String::String(double v, int decimals)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+}
+
+static char* toBase(unsigned long v, bool negative, char* buf, int base)
+{
+    char tmp[34];
+    int n = 0;
+    do
+    {
+        int d = v % base;
+        tmp[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+        v /= base;
+    } while (v);
+    char* p = buf;
+    if (negative)
+        *p++ = '-';
+    while (n) *p++ = tmp[--n];
+    *p = '\0';
+    return buf;
+}
+
+char* itoa(int value, char* buf, int base) { return ltoa(value, buf, base); }
+
+char* ltoa(long value, char* buf, int base)
+{
+    bool negative = value < 0 && base == 10;
+    unsigned long v = negative ? -(unsigned long)value : (unsigned long)value;
+    return toBase(v, negative, buf, base);
+}
+
+char* ultoa(unsigned long value, char* buf, int base) { return toBase(value, false, buf, base); }
+
+/* ===== Print ===== */
+
+size_t Print::write(const uint8_t* buf, size_t n)
+{
+    for (size_t i = 0; i < n; i++) write(buf[i]);
+    return n;
+}
+
+size_t Print::print(long v, int base)
+{
+    char buf[34];
+    return write(ltoa(v, buf, base));
+}
+
+size_t Print::print(unsigned long v, int base)
+{
+    char buf[34];
+    return write(ultoa(v, buf, base));
+}
+
+size_t Print::print(double v, int decimals) { return print(String(v, decimals)); }
+
+/* ===== EEPROM ===== */
+
+EEPROMClass EEPROM;
+static uint8_t eeprom[E2END + 1];
+static bool eepromErased = false;
+static uint64_t eepromBusyUntil;
+static uint32_t eepromWrites[E2END + 1];
+
+static void eepromInit()
+{
+    if (!eepromErased)
+    {
+        memset(eeprom, 0xFF, sizeof(eeprom));
+        eepromErased = true;
+    }
+}
+
+bool eeprom_is_ready() { return SimClock.nowUs() >= eepromBusyUntil; }
+
+uint8_t EEPROMClass::read(int idx)
+{
+    eepromInit();
+    if (!eeprom_is_ready())
+        SimClock.advanceTo(eepromBusyUntil);
+    return idx >= 0 && idx <= E2END ? eeprom[idx] : 0xFF;
+}
+
+void EEPROMClass::write(int idx, uint8_t val)
+{
+    eepromInit();
+    if (idx < 0 || idx > E2END)
+        return;
+    if (!eeprom_is_ready())
+        SimClock.advanceTo(eepromBusyUntil);
+    eeprom[idx] = val;
+    eepromWrites[idx]++;
+    eepromBusyUntil = SimClock.nowUs() + SIM_EEPROM_WRITE_US;
+}
+
+void EEPROMClass::update(int idx, uint8_t val)
+{
+    if (read(idx) != val)
+        write(idx, val);
+}
+
+uint32_t simEepromWrites(int idx) { return idx >= 0 && idx <= E2END ? eepromWrites[idx] : 0; }
+
+bool simLoadEeprom(const char* path)
+{
+    eepromInit();
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    size_t n = fread(eeprom, 1, sizeof(eeprom), f);
+    fclose(f);
+    return n == sizeof(eeprom);
+}
+
+bool simSaveEeprom(const char* path)
+{
+    eepromInit();
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+    size_t n = fwrite(eeprom, 1, sizeof(eeprom), f);
+    fclose(f);
+    return n == sizeof(eeprom);
+}
+
+int freeMemory() { return 0; }
@@ -0,0 +1,31 @@
+#ifndef __SIM_ARDUINO_HOST__
+#define __SIM_ARDUINO_HOST__
+
+#include <stdint.h>
+
+/** @brief Write time of an EEPROM cell (us). */
+#define SIM_EEPROM_WRITE_US 3300
+
+/**
+ * @brief Load the EEPROM image from a file, to keep parameters and journal between runs.
+ *
+ * @return false if the file cannot be read (the EEPROM stays erased).
+ */
+bool simLoadEeprom(const char* path);
+
+/**
+ * @brief Save the EEPROM image to a file.
+ */
+bool simSaveEeprom(const char* path);
+
+/**
+ * @brief Number of writes to an EEPROM cell since the start, for wear checks.
+ */
+uint32_t simEepromWrites(int idx);
+
+/**
+ * @brief Level written on a pin, or the analogWrite() duty.
+ */
+int simPinLevel(uint8_t pin);
+
+#endif
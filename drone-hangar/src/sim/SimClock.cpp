@@ -0,0 +1,151 @@
+#include "sim/SimClock.hpp"
+
+#include <TimerOne.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+
+#include <chrono>
+#include <thread>
+
+extern "C" void TIMER0_COMPA_vect(void);
+
+SimClockClass SimClock;
+TimerOne Timer1;
+
+SimClockClass::SimClockClass()
+    : now(0),
+      timer1Next(SIM_NEVER),
+      timer1Last(0),
+      timer1Period(0),
+      timer1Isr(nullptr),
+      timer0Next(SIM_TIMER0_US),
+      nSources(0),
+      nInterrupts(0),
+      realTime(false),
+      wallStartUs(0)
+{
+}
+
+static uint64_t wallUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void SimClockClass::setRealTime(bool enabled)
+{
+    realTime = enabled;
+    wallStartUs = wallUs() - now;
+}
+
+void SimClockClass::waitWallClock()
+{
+    uint64_t wall = wallUs();
+    if (wallStartUs + now > wall + SIM_PACE_US)
+        std::this_thread::sleep_for(std::chrono::microseconds(wallStartUs + now - wall));
+}
+
+void SimClockClass::advance(uint64_t us) { advanceTo(now + us); }
+
+void SimClockClass::advanceTo(uint64_t t)
+{
+    for (;;)
+    {
+        // Earliest of the timers and the event sources, timers first on a tie
+        uint64_t next = timer1Next < timer0Next ? timer1Next : timer0Next;
+        int8_t source = -1;
+        for (uint8_t i = 0; i < nSources; i++)
+        {
+            uint64_t at = sources[i]->nextAt();
+            if (at < next)
+            {
+                next = at;
+                source = i;
+            }
+        }
+        if (next > t)
+            break;
+
+        if (next > now)
+            now = next;
+        if (realTime)
+            waitWallClock();  // nothing runs before its time
+        if (source >= 0)
+        {
+            sources[source]->fire();
+        }
+        else if (next == timer1Next)
+        {
+            timer1Last = timer1Next;
+            timer1Next += timer1Period;
+            nInterrupts++;
+            timer1Isr();
+        }
+        else
+        {
+            timer0Next += SIM_TIMER0_US;
+            if (TIMSK0 & _BV(OCIE0A))
+            {
+                nInterrupts++;
+                TIMER0_COMPA_vect();
+            }
+        }
+    }
+    if (t > now)
+        now = t;
+    if (realTime)
+        waitWallClock();
+}
+
+void SimClockClass::idle()
+{
+    uint64_t next = timer1Next < timer0Next ? timer1Next : timer0Next;
+    for (uint8_t i = 0; i < nSources; i++)
+    {
+        uint64_t at = sources[i]->nextAt();
+        if (at < next)
+            next = at;
+    }
+    advanceTo(next > now ? next : now);
+}
+
+void SimClockClass::setTimer1(uint32_t periodUs, void (*isr)())
+{
+    timer1Period = periodUs;
+    timer1Isr = isr;
+    timer1Next = (isr && periodUs) ? now + periodUs : SIM_NEVER;
+}
+
+bool SimClockClass::addSource(SimEventSource* source)
+{
+    if (nSources >= SIM_MAX_SOURCES)
+        return false;
+    sources[nSources++] = source;
+    return true;
+}
+
+/* ===== TimerOne ===== */
+
+static long timer1Us;
+static void (*timer1Handler)();
+
+void TimerOne::initialize(long microseconds) { setPeriod(microseconds); }
+
+void TimerOne::setPeriod(long microseconds)
+{
+    timer1Us = microseconds;
+    SimClock.setTimer1(timer1Us, timer1Handler);
+}
+
+void TimerOne::attachInterrupt(void (*isr)())
+{
+    timer1Handler = isr;
+    SimClock.setTimer1(timer1Us, timer1Handler);
+}
+
+void TimerOne::detachInterrupt() { attachInterrupt(nullptr); }
+
+/* ===== Sleep ===== */
+
+void sleep_cpu() { SimClock.idle(); }
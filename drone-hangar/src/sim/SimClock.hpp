@@ -0,0 +1,94 @@
+#ifndef __SIM_CLOCK__
+#define __SIM_CLOCK__
+
+#include <stdint.h>
+
+/** @brief Virtual time charged to every clock read (us). */
+#define SIM_CALL_US 1
+
+/** @brief Timer0 overflow period: 256 * 64 / 16 MHz (us). */
+#define SIM_TIMER0_US 1024
+
+/** @brief Real time mode: lead over the wall clock that makes the host sleep (us). */
+#define SIM_PACE_US 1000
+
+#define SIM_MAX_SOURCES 4
+#define SIM_NEVER UINT64_MAX
+
+/**
+ * @brief Something that happens at a virtual time: a stimulus, a replayed sample.
+ */
+class SimEventSource
+{
+   public:
+    /** @brief Time of the next event (us), SIM_NEVER if none. */
+    virtual uint64_t nextAt() = 0;
+
+    /** @brief Apply the event due at nextAt(). */
+    virtual void fire() = 0;
+};
+
+/**
+ * @brief Virtual time of the native build, in us from reset.
+ *
+ * The clock only moves when the firmware waits (sleep, delay, blocking
+ * I/O); the interrupts and events due in the meantime then run in time
+ * order, at their own time. Timer1 runs the scheduler tick, the Timer0
+ * compare A interrupt the LED patterns. Timer2 is not simulated: the
+ * simulated servo does not use it.
+ *
+ * By default the clock jumps: a replay runs as fast as the host allows.
+ * In real time mode it waits for the wall clock instead, so a run lasts
+ * as long as on the board.
+ */
+class SimClockClass
+{
+   private:
+    uint64_t now;
+    uint64_t timer1Next;
+    uint64_t timer1Last; /**< Last Timer1 interrupt */
+    uint32_t timer1Period;
+    void (*timer1Isr)();
+    uint64_t timer0Next;
+    SimEventSource* sources[SIM_MAX_SOURCES];
+    uint8_t nSources;
+    uint32_t nInterrupts;
+    bool realTime;
+    uint64_t wallStartUs; /**< Wall clock at virtual time 0, real time mode */
+
+    void waitWallClock();
+
+   public:
+    SimClockClass();
+
+    uint64_t nowUs() const { return now; }
+
+    /**
+     * @brief Let time pass, running what is due on the way.
+     */
+    void advance(uint64_t us);
+    void advanceTo(uint64_t t);
+
+    /**
+     * @brief Sleep until the next interrupt or event, and run it.
+     */
+    void idle();
+
+    void setTimer1(uint32_t periodUs, void (*isr)());
+    bool addSource(SimEventSource* source);
+
+    /**
+     * @brief Pace the virtual time on the wall clock (1x), from now on.
+     */
+    void setRealTime(bool enabled);
+
+    /** @brief Time of the last Timer1 interrupt (us), the start of the scheduler slot. */
+    uint64_t getTimer1Last() const { return timer1Last; }
+
+    /** @brief Interrupts run so far. */
+    uint32_t getInterrupts() const { return nInterrupts; }
+};
+
+extern SimClockClass SimClock;
+
+#endif
@@ -0,0 +1,192 @@
+#include "sim/SimDevices.hpp"
+
+#include <LiquidCrystal_I2C.h>
+
+#include "config.hpp"
+#include "devices/ServoTimer2.hpp"
+#include "kernel/InputEvents.hpp"
+#include "sim/SimClock.hpp"
+
+#define SIM_SOUND_SPEED 343.0f     // m/s at 20 degC, as Sonar
+#define SIM_SONAR_TIMEOUT_US 30000 // HWPlatform MAX_TIME
+#define SIM_TEMP_READ_US 560       // 5 ADC conversions
+
+SimHardware SimHW;
+
+/* ===== Sonar ===== */
+
+SimProximitySensor::SimProximitySensor() : distance(-1) {}
+
+float SimProximitySensor::getDistance()
+{
+    // pulseIn() blocks for the echo, or up to the timeout
+    uint64_t echoUs = distance < 0 ? SIM_SONAR_TIMEOUT_US : (uint64_t)(2e6f * distance / SIM_SOUND_SPEED);
+    if (echoUs >= SIM_SONAR_TIMEOUT_US)
+    {
+        SimClock.advance(SIM_SONAR_TIMEOUT_US);
+        return -1;  // NO_OBJ_DETECTED
+    }
+    SimClock.advance(echoUs);
+    return distance;
+}
+
+void SimProximitySensor::set(float meters) { distance = meters; }
+
+/* ===== Temperature ===== */
+
+SimTempSensor::SimTempSensor() : temperature(20) {}
+
+float SimTempSensor::getTemperature()
+{
+    SimClock.advance(SIM_TEMP_READ_US);
+    return temperature;
+}
+
+void SimTempSensor::set(float celsius) { temperature = celsius; }
+
+/* ===== PIR ===== */
+
+SimPresenceSensor::SimPresenceSensor() : detected(false), warmUpStart(0) {}
+
+bool SimPresenceSensor::isDetected() { return detected; }
+
+bool SimPresenceSensor::isReady() { return millis() - warmUpStart >= PIR_WARMUP_MS; }
+
+void SimPresenceSensor::calibrate() { warmUpStart = millis(); }
+
+void SimPresenceSensor::set(bool detected)
+{
+    if (detected == this->detected)
+        return;
+    this->detected = detected;
+    InputEvents.push(detected ? INPUT_PIR_RISE : INPUT_PIR_FALL, millis());
+}
+
+/* ===== Button ===== */
+
+SimButton::SimButton() : pressed(false) {}
+
+bool SimButton::isPressed() { return pressed; }
+
+void SimButton::set(bool pressed)
+{
+    if (pressed == this->pressed)
+        return;
+    this->pressed = pressed;
+    InputEvents.push(pressed ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, millis());
+}
+
+/* ===== Servo ===== */
+
+SimServoMotor::SimServoMotor() : _on(false), frameAt(0) {}
+
+void SimServoMotor::catchUp()
+{
+    uint64_t now = SimClock.nowUs();
+    if (!motion.isMoving())
+    {
+        if (frameAt <= now)
+            frameAt += ((now - frameAt) / FRAME_SYNC_PERIOD + 1) * FRAME_SYNC_PERIOD;  // keep the frame phase
+        return;
+    }
+    while (frameAt <= now)
+    {
+        motion.advance();
+        frameAt += FRAME_SYNC_PERIOD;
+    }
+}
+
+void SimServoMotor::on()
+{
+    _on = true;
+    frameAt = SimClock.nowUs() + FRAME_SYNC_PERIOD;
+}
+
+bool SimServoMotor::isOn() { return _on; }
+
+void SimServoMotor::setPosition(int angle)
+{
+    catchUp();
+    motion.hold(constrain(angle, 0, 180) * 100);
+}
+
+void SimServoMotor::moveTo(int angle, unsigned long durationMs)
+{
+    catchUp();
+    unsigned long frames = durationMs * 1000UL / FRAME_SYNC_PERIOD;
+    motion.start(constrain(angle, 0, 180) * 100, frames > 0xFFFF ? 0xFFFF : frames, SERVO_MOTION_SHAPE,
+                 SERVO_RAMP_DIV);
+}
+
+bool SimServoMotor::isMoving()
+{
+    catchUp();
+    return motion.isMoving();
+}
+
+int SimServoMotor::getPosition()
+{
+    catchUp();
+    return (motion.position() + 50) / 100;
+}
+
+void SimServoMotor::off() { _on = false; }
+
+/* ===== LEDs ===== */
+
+SimLight::SimLight(uint8_t pin) : pin(pin) {}
+
+uint8_t SimLight::level() const
+{
+    if (digitalPinToTimer(pin) == TIMER0B && (TCCR0A & _BV(COM0B1)))
+        return OCR0B;
+    return (*portOutputRegister(digitalPinToPort(pin)) & digitalPinToBitMask(pin)) ? 255 : 0;
+}
+
+/* ===== LCD ===== */
+
+LiquidCrystal_I2C* LiquidCrystal_I2C::instance = nullptr;
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t, uint8_t cols, uint8_t rows)
+    : cols(min(cols, (uint8_t)40)), rows(min(rows, (uint8_t)4)), col(0), row(0), writes(0)
+{
+    memset(glass, ' ', sizeof(glass));
+    instance = this;
+}
+
+void LiquidCrystal_I2C::init() { clear(); }
+
+void LiquidCrystal_I2C::clear()
+{
+    memset(glass, ' ', sizeof(glass));
+    col = 0;
+    row = 0;
+    writes++;
+    SimClock.advance(SIM_LCD_CLEAR_US);
+}
+
+void LiquidCrystal_I2C::home()
+{
+    col = 0;
+    row = 0;
+    writes++;
+    SimClock.advance(SIM_LCD_CLEAR_US);
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row)
+{
+    this->col = col;
+    this->row = row < rows ? row : rows - 1;
+    writes++;
+    SimClock.advance(SIM_LCD_WRITE_US);
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t c)
+{
+    if (col < cols)
+        glass[row][col] = c;
+    col++;
+    writes++;
+    SimClock.advance(SIM_LCD_WRITE_US);
+    return 1;
+}
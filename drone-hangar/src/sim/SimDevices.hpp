@@ -0,0 +1,135 @@
+#ifndef __SIM_DEVICES__
+#define __SIM_DEVICES__
+
+#include <Arduino.h>
+
+#include "config.hpp"
+#include "devices/Button.hpp"
+#include "devices/MotionProfile.hpp"
+#include "devices/PresenceSensor.hpp"
+#include "devices/ProximitySensor.hpp"
+#include "devices/ServoMotor.hpp"
+#include "devices/TempSensor.hpp"
+
+/*
+ * Simulated devices of the native build, behind the same interfaces as
+ * the real ones. The host sets what the sensors see; reading a sensor
+ * costs the virtual time the real one blocks for.
+ */
+
+/**
+ * @brief Sonar: returns the distance set by the host.
+ */
+class SimProximitySensor : public ProximitySensor
+{
+   private:
+    float distance; /**< m, negative if nothing in range */
+
+   public:
+    SimProximitySensor();
+    float getDistance() override;
+    void set(float meters);
+};
+
+/**
+ * @brief TMP36: returns the temperature set by the host.
+ */
+class SimTempSensor : public TempSensor
+{
+   private:
+    float temperature;
+
+   public:
+    SimTempSensor();
+    float getTemperature() override;
+    void set(float celsius);
+};
+
+/**
+ * @brief PIR: edges are queued in InputEvents, like the interrupt of Pir does.
+ */
+class SimPresenceSensor : public PresenceSensor
+{
+   private:
+    bool detected;
+    unsigned long warmUpStart;
+
+   public:
+    SimPresenceSensor();
+    bool isDetected() override;
+    bool isReady() override;
+    void calibrate();
+    void set(bool detected);
+};
+
+/**
+ * @brief Button: clean edges queued in InputEvents, no bounce.
+ */
+class SimButton : public Button
+{
+   private:
+    bool pressed;
+
+   public:
+    SimButton();
+    bool isPressed() override;
+    void set(bool pressed);
+};
+
+/**
+ * @brief Servo that follows the motion profiles of ServoTimer2, one step per 20 ms frame.
+ *
+ * Positions are kept in 1/100 degree.
+ */
+class SimServoMotor : public ServoMotor
+{
+   private:
+    MotionProfile motion;
+    bool _on;
+    uint64_t frameAt; /**< Virtual time of the next frame */
+
+    void catchUp();
+
+   public:
+    SimServoMotor();
+    void on() override;
+    bool isOn() override;
+    void setPosition(int angle) override;
+    void moveTo(int angle, unsigned long durationMs) override;
+    bool isMoving() override;
+    int getPosition() override;
+    void off() override;
+};
+
+/**
+ * @brief LED on a pin. Its level is read back from the registers, which
+ * LedPatternEngine writes directly.
+ */
+class SimLight
+{
+   private:
+    uint8_t pin;
+
+   public:
+    SimLight(uint8_t pin);
+
+    /** @brief 0 to 255, 0 when off. */
+    uint8_t level() const;
+};
+
+/**
+ * @brief The devices HWPlatform hands out in the native build.
+ */
+struct SimHardware
+{
+    SimProximitySensor sonar;
+    SimTempSensor temp;
+    SimPresenceSensor pir;
+    SimButton button;
+    SimServoMotor servo;
+    SimLight l1{L1_PIN}, l2{L2_PIN}, l3{L3_PIN};  // read back only
+};
+
+extern SimHardware SimHW;
+
+#endif
@@ -0,0 +1,156 @@
+#include <Arduino.h>
+#include <LiquidCrystal_I2C.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "config.hpp"
+#include "model/Context.hpp"
+#include "sim/SimArduino.hpp"
+#include "sim/SimClock.hpp"
+#include "sim/SimDevices.hpp"
+#include "sim/SimScript.hpp"
+#include "sim/SimSerial.hpp"
+
+/*
+ * Entry point of the native build: runs setup() and loop() of main.cpp,
+ * unmodified, on the virtual clock and as fast as the host allows (or at
+ * the pace of the board with -r).
+ *
+ *   sim [-t seconds] [-s script] [-e eeprom.bin] [-o state.txt] [-q] [-r]
+ *
+ * The serial output goes to stdout (-q drops it), the summary to stderr.
+ * With -o, one line per scheduler slot records the state the slot left:
+ * the same script gives the same file, so two firmware versions can be
+ * compared with diff.
+ *
+ * Unit tests (test/, pio test -e native) link the same sources and bring
+ * their own main().
+ */
+#ifndef PIO_UNIT_TESTING
+
+void setup();
+void loop();
+void serialEvent();
+
+extern Context* pContext;
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: sim [-t seconds] [-s script] [-e eeprom.bin] [-o state.txt] [-q] [-r]\n"
+            "  -t  virtual time to run, default 60 s\n"
+            "  -s  stimuli or a trace from tools/tracecap, see sim/SimScript.hpp\n"
+            "  -e  EEPROM image, loaded at start and saved at the end\n"
+            "  -o  state after every scheduler slot\n"
+            "  -q  discard the serial output\n"
+            "  -r  real time, 1x\n");
+}
+
+/*
+ * <slot ms> drone=<state> hangar=<state> door=<open>/<deg> in=<0/1>
+ *   pir=<active>/<ready> dist=<m> temp=<degC> lcd=<message> leds=<L1>/<L2>/<L3>
+ *
+ * Only what the firmware decided, never how long it took: the line of a
+ * slot has its start time, not the time the tasks ended.
+ */
+static void dumpState(FILE* out)
+{
+    static const char* const hangar[] = {HANGAR_NORMAL_STATE, HANGAR_PRE_ALARM_STATE, HANGAR_ALARM_STATE};
+    const ContextSnapshot& snap = pContext->getSnapshot();
+    fprintf(out, "%llu drone=%d hangar=%s door=%u/%u in=%u pir=%u/%u dist=%.3f temp=%.2f lcd=%u leds=%u/%u/%u\n",
+            (unsigned long long)(SimClock.getTimer1Last() / 1000), snap.droneState,
+            hangar[snap.alarmActive ? 2 : snap.preAlarmActive], snap.doorOpen, snap.doorAngle, snap.droneIn,
+            snap.pirActive, snap.pirReady, snap.distance, snap.temperature, snap.lcdMessage, SimHW.l1.level(),
+            SimHW.l2.level(), SimHW.l3.level());
+}
+
+static void report(double wallS)
+{
+    double simS = SimClock.nowUs() / 1e6;
+    fprintf(stderr, "sim: %.3f s simulated in %.3f s, %.0fx real time, %u interrupts\n", simS, wallS,
+            wallS > 0 ? simS / wallS : 0.0, SimClock.getInterrupts());
+    fprintf(stderr, "sim: L1 %u L2 %u L3 %u, door %d deg\n", SimHW.l1.level(), SimHW.l2.level(), SimHW.l3.level(),
+            SimHW.servo.getPosition());
+
+    const LiquidCrystal_I2C* lcd = LiquidCrystal_I2C::instance;
+    if (lcd)
+    {
+        for (uint8_t r = 0; r < lcd->getRows(); r++)
+            fprintf(stderr, "sim: |%.*s|\n", lcd->getCols(), lcd->line(r));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 60;
+    const char* eepromPath = nullptr;
+    FILE* stateOut = nullptr;
+    bool realTime = false;
+    SimScript script;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "-t") && hasValue)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && hasValue)
+        {
+            if (!script.load(argv[++i]))
+                return 1;
+        }
+        else if (!strcmp(argv[i], "-e") && hasValue)
+            eepromPath = argv[++i];
+        else if (!strcmp(argv[i], "-o") && hasValue)
+        {
+            const char* path = argv[++i];
+            stateOut = fopen(path, "w");
+            if (!stateOut)
+            {
+                fprintf(stderr, "sim: cannot write %s\n", path);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-q"))
+            SimSerial.setSink(nullptr);
+        else if (!strcmp(argv[i], "-r"))
+            realTime = true;
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (eepromPath)
+        simLoadEeprom(eepromPath);
+    SimClock.addSource(&script);
+    SimClock.addSource(&SimSerial);
+    SimClock.setRealTime(realTime);
+
+    uint64_t end = (uint64_t)(seconds * 1e6);
+    auto start = std::chrono::steady_clock::now();
+
+    // The loop of the Arduino core
+    setup();
+    while (SimClock.nowUs() < end)
+    {
+        loop();
+        if (stateOut)
+            dumpState(stateOut);
+        if (Serial.available())
+            serialEvent();
+    }
+    if (stateOut)
+        fclose(stateOut);
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    fflush(stdout);
+    report(wall.count());
+    if (eepromPath && !simSaveEeprom(eepromPath))
+        fprintf(stderr, "sim: cannot write %s\n", eepromPath);
+    return 0;
+}
+
+#endif
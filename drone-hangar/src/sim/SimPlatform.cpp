@@ -0,0 +1,35 @@
+#include "model/HWPlatform.hpp"
+
+#include "config.hpp"
+#include "devices/LCD.hpp"
+#include "kernel/BootProfile.hpp"
+#include "kernel/Logger.hpp"
+#include "sim/SimDevices.hpp"
+
+/*
+ * Native build: HWPlatform hands out the simulated devices. The LCD is the
+ * real driver over the simulated LiquidCrystal_I2C, and the Pir member is
+ * constructed but never calibrated, so its interrupt stays detached.
+ */
+HWPlatform::HWPlatform() : pir(DPD_PIN)
+{
+    this->button = &SimHW.button;
+    this->motor = &SimHW.servo;
+    this->tempSensor = &SimHW.temp;
+    this->proximitySensor = &SimHW.sonar;
+    this->presenceSensor = &SimHW.pir;
+    BootProfile.mark(BOOT_DEVICES);
+
+    this->lcd = new LCD(LCD_ADR, LCD_COL, LCD_ROW);
+    BootProfile.mark(BOOT_LCD);
+}
+
+void HWPlatform::init()
+{
+    motor->on();
+    BootProfile.mark(BOOT_SERVO);
+
+    Logger.log(LOG_PIR_CALIBRATING);
+    SimHW.pir.calibrate();
+    BootProfile.mark(BOOT_PIR);
+}
@@ -0,0 +1,70 @@
+#include "sim/SimScript.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim/SimDevices.hpp"
+#include "sim/SimSerial.hpp"
+
+SimScript::SimScript() : next(0) {}
+
+bool SimScript::load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "sim: cannot open %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    unsigned n = 0;
+    uint64_t last = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        n++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* p = line + strspn(line, " \t");
+        if (*p == '\0' || *p == '#')
+            continue;
+
+        char* end;
+        unsigned long ms = strtoul(p, &end, 10);
+        char input[16];
+        int used = 0;
+        if (end == p || sscanf(end, " %15s %n", input, &used) != 1 || (uint64_t)ms * 1000 < last)
+        {
+            fprintf(stderr, "sim: %s:%u: expected \"<ms> <input> <value>\" in time order\n", path, n);
+            fclose(f);
+            return false;
+        }
+        last = (uint64_t)ms * 1000;
+        steps.push_back({last, input, end + used});
+    }
+    fclose(f);
+    return true;
+}
+
+uint64_t SimScript::nextAt() { return next < steps.size() ? steps[next].at : SIM_NEVER; }
+
+void SimScript::fire()
+{
+    const Step& s = steps[next++];
+    const char* v = s.value.c_str();
+    if (s.input == "distance")
+        SimHW.sonar.set(atof(v));
+    else if (s.input == "temp")
+        SimHW.temp.set(atof(v));
+    else if (s.input == "pir")
+        SimHW.pir.set(atoi(v) != 0);
+    else if (s.input == "button")
+        SimHW.button.set(atoi(v) != 0);
+    else if (s.input == "serial")
+    {
+        SimSerial.inject(v, s.value.size());
+        SimSerial.inject("\n", 1);
+    }
+    else
+        fprintf(stderr, "sim: unknown input %s\n", s.input.c_str());
+}
@@ -0,0 +1,43 @@
+#ifndef __SIM_SCRIPT__
+#define __SIM_SCRIPT__
+
+#include <string>
+#include <vector>
+
+#include "sim/SimClock.hpp"
+
+/**
+ * @brief Stimuli read from a text file, one per line: "<ms> <input> <value>".
+ *
+ * Inputs: distance (m, negative for no echo), temp (degC), pir (0/1),
+ * button (0/1), serial (rest of the line, sent with a '\n'). Blank lines
+ * and lines starting with '#' are skipped. Lines must be in time order.
+ * tools/tracecap.cpp writes a capture of the board in this format.
+ */
+class SimScript : public SimEventSource
+{
+   private:
+    struct Step
+    {
+        uint64_t at; /**< us */
+        std::string input;
+        std::string value;
+    };
+    std::vector<Step> steps;
+    size_t next;
+
+   public:
+    SimScript();
+
+    /**
+     * @brief Read a script.
+     *
+     * @return false, with a message on stderr, on a missing file or a bad line.
+     */
+    bool load(const char* path);
+
+    uint64_t nextAt() override;
+    void fire() override;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "sim/SimSerial.hpp"
+
+#include <Arduino.h>
+#include <stdio.h>
+
+#include "sim/SimClock.hpp"
+
+SimSerialPort SimSerial;
+HardwareSerial Serial;
+
+static void stdoutSink(uint8_t c) { putchar(c); }
+
+SimSerialPort::SimSerialPort()
+    : rxHead(0), rxCount(0), baud(9600), txIdleAt(0), rxDropped(0), wireHead(0), wireNextAt(0), sink(stdoutSink)
+{
+}
+
+uint64_t SimSerialPort::byteUs() const { return 10000000ULL / baud; }
+
+void SimSerialPort::begin(unsigned long baud) { this->baud = baud ? baud : 9600; }
+
+int SimSerialPort::available() { return rxCount; }
+
+int SimSerialPort::peek() { return rxCount ? rx[rxHead] : -1; }
+
+int SimSerialPort::read()
+{
+    if (rxCount == 0)
+        return -1;
+    uint8_t c = rx[rxHead];
+    rxHead = (rxHead + 1) % SIM_SERIAL_BUFFER;
+    rxCount--;
+    return c;
+}
+
+int SimSerialPort::availableForWrite()
+{
+    uint64_t now = SimClock.nowUs();
+    uint64_t queued = txIdleAt > now ? (txIdleAt - now + byteUs() - 1) / byteUs() : 0;
+    return queued >= SIM_SERIAL_BUFFER - 1 ? 0 : SIM_SERIAL_BUFFER - 1 - (int)queued;
+}
+
+void SimSerialPort::flush()
+{
+    if (txIdleAt > SimClock.nowUs())
+        SimClock.advanceTo(txIdleAt);
+}
+
+void SimSerialPort::write(uint8_t c)
+{
+    if (availableForWrite() == 0)
+        SimClock.advanceTo(txIdleAt - (SIM_SERIAL_BUFFER - 2) * byteUs());
+    uint64_t now = SimClock.nowUs();
+    txIdleAt = (txIdleAt > now ? txIdleAt : now) + byteUs();
+    if (sink)
+        sink(c);
+}
+
+void SimSerialPort::inject(const char* data, size_t len)
+{
+    if (wireHead == wire.size())
+    {
+        wire.clear();
+        wireHead = 0;
+        wireNextAt = SimClock.nowUs() + byteUs();
+    }
+    wire.append(data, len);
+}
+
+uint64_t SimSerialPort::nextAt() { return wireHead < wire.size() ? wireNextAt : SIM_NEVER; }
+
+void SimSerialPort::fire()
+{
+    if (rxCount < SIM_SERIAL_BUFFER)
+    {
+        rx[(rxHead + rxCount) % SIM_SERIAL_BUFFER] = (uint8_t)wire[wireHead];
+        rxCount++;
+    }
+    else
+    {
+        rxDropped++;
+    }
+    wireHead++;
+    wireNextAt += byteUs();
+}
+
+void SimSerialPort::setSink(void (*sink)(uint8_t c)) { this->sink = sink; }
+
+/* ===== HardwareSerial ===== */
+
+void HardwareSerial::begin(unsigned long baud) { SimSerial.begin(baud); }
+int HardwareSerial::available() { return SimSerial.available(); }
+int HardwareSerial::peek() { return SimSerial.peek(); }
+int HardwareSerial::read() { return SimSerial.read(); }
+int HardwareSerial::availableForWrite() { return SimSerial.availableForWrite(); }
+void HardwareSerial::flush() { SimSerial.flush(); }
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    SimSerial.write(c);
+    return 1;
+}
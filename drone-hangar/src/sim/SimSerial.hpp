@@ -0,0 +1,66 @@
+#ifndef __SIM_SERIAL__
+#define __SIM_SERIAL__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "sim/SimClock.hpp"
+
+/** @brief RX and TX buffers of the Arduino core. */
+#define SIM_SERIAL_BUFFER 64
+
+/**
+ * @brief The UART behind Serial.
+ *
+ * TX bytes leave one per 10 bit times and are handed to the sink when
+ * written; a write to a full buffer waits for a free byte. RX bytes sent
+ * by the host arrive at the same rate, one event each, and are dropped
+ * when the buffer is full, as on the board.
+ */
+class SimSerialPort : public SimEventSource
+{
+   private:
+    uint8_t rx[SIM_SERIAL_BUFFER];
+    uint8_t rxHead, rxCount;
+    unsigned long baud;
+    uint64_t txIdleAt; /**< Time the last queued TX byte is out */
+    uint32_t rxDropped;
+    std::string wire;  /**< Sent by the host, not arrived yet */
+    size_t wireHead;
+    uint64_t wireNextAt; /**< Arrival of wire[wireHead] */
+    void (*sink)(uint8_t c);
+
+    uint64_t byteUs() const;
+
+   public:
+    SimSerialPort();
+
+    void begin(unsigned long baud);
+    int available();
+    int peek();
+    int read();
+    int availableForWrite();
+    void flush();
+    void write(uint8_t c);
+
+    /**
+     * @brief Bytes sent by the host side, from now on at the baud rate.
+     *
+     * The clock must run this port as an event source.
+     */
+    void inject(const char* data, size_t len);
+
+    uint64_t nextAt() override;
+    void fire() override;
+
+    /** @brief Called with every TX byte, nullptr to discard them. */
+    void setSink(void (*sink)(uint8_t c));
+
+    uint32_t getRxDropped() const { return rxDropped; }
+};
+
+extern SimSerialPort SimSerial;
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef __SIM_ARDUINO__
+#define __SIM_ARDUINO__
+
+/*
+ * Arduino API for the native build, over the virtual clock of SimClock.
+ *
+ * Only what the firmware uses is here. Time never passes while firmware
+ * code runs, except where the real call would take time: delays, pulseIn,
+ * a full serial TX buffer, an EEPROM write, an LCD transfer, and the
+ * clock reads themselves (SIM_CALL_US each), so busy-wait loops end.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <type_traits>
+
+#include "avr/interrupt.h"
+#include "avr/io.h"
+#include "avr/pgmspace.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define NUM_DIGITAL_PINS 20
+#define NOT_AN_INTERRUPT -1
+#define NOT_ON_TIMER 0
+#define TIMER0A 1
+#define TIMER0B 2
+
+/* Functions rather than the macros of the AVR core, which break the C++ headers */
+template <typename T, typename U>
+constexpr typename std::common_type<T, U>::type min(const T& a, const U& b)
+{
+    return b < a ? b : a;
+}
+
+template <typename T, typename U>
+constexpr typename std::common_type<T, U>::type max(const T& a, const U& b)
+{
+    return a < b ? b : a;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/* ===== Time ===== */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/* ===== Pins ===== */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000L);
+
+#define digitalPinToPort(p) ((uint8_t)((p) < 8 ? 4 : ((p) < 14 ? 2 : 3)))
+#define digitalPinToBitMask(p) ((uint8_t)_BV((p) < 8 ? (p) : ((p) < 14 ? (p)-8 : (p)-14)))
+#define portInputRegister(P) ((P) == 2 ? &PINB : ((P) == 3 ? &PINC : &PIND))
+#define portOutputRegister(P) ((P) == 2 ? &PORTB : ((P) == 3 ? &PORTC : &PORTD))
+#define digitalPinToPCICR(p) (&PCICR)
+#define digitalPinToPCICRbit(p) ((p) < 8 ? 2 : ((p) < 14 ? 0 : 1))
+#define digitalPinToPCMSK(p) (&PCMSK0)
+#define digitalPinToPCMSKbit(p) ((p) < 8 ? (p) : ((p) < 14 ? (p)-8 : (p)-14))
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+#define digitalPinToTimer(p) ((p) == 6 ? TIMER0A : ((p) == 5 ? TIMER0B : NOT_ON_TIMER))
+
+/* ===== Interrupts ===== */
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+/* ===== Strings ===== */
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+char* itoa(int value, char* buf, int base);
+char* ltoa(long value, char* buf, int base);
+char* ultoa(unsigned long value, char* buf, int base);
+
+/**
+ * @brief Arduino String over std::string.
+ */
+class String
+{
+   private:
+    std::string s;
+
+   public:
+    String(const char* c = "") : s(c ? c : "") {}
+    String(const __FlashStringHelper* f) : s((const char*)f) {}
+    String(char c) : s(1, c) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned int v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+    String(double v, int decimals = 2);
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.size(); }
+    char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator!=(const String& o) const { return s != o.s; }
+
+    String& operator+=(const String& o)
+    {
+        s += o.s;
+        return *this;
+    }
+    friend String operator+(const String& a, const String& b)
+    {
+        String r(a);
+        r += b;
+        return r;
+    }
+};
+
+/* ===== Serial ===== */
+#define DEC 10
+#define HEX 16
+
+/**
+ * @brief Arduino Print: every overload ends in write().
+ */
+class Print
+{
+   public:
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t n);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(double v, int decimals = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T& v, int format)
+    {
+        size_t n = print(v, format);
+        return n + println();
+    }
+};
+
+/**
+ * @brief UART at the configured baud rate, with the 64 byte buffers of the core.
+ *
+ * TX bytes leave at the baud rate and go to the sink set by SimSerial.
+ */
+class HardwareSerial : public Print
+{
+   public:
+    void begin(unsigned long baud);
+    void end() {}
+    int available();
+    int peek();
+    int read();
+    int availableForWrite();
+    void flush();
+    size_t write(uint8_t c) override;
+    using Print::write;
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __SIM_EEPROM__
+#define __SIM_EEPROM__
+
+#include <stdint.h>
+
+#include "avr/eeprom.h"
+#include "avr/io.h"
+
+/**
+ * @brief 1 KB EEPROM in RAM, erased (0xFF) at start unless loaded from a file.
+ */
+class EEPROMClass
+{
+   public:
+    uint8_t read(int idx);
+    void write(int idx, uint8_t val);
+    void update(int idx, uint8_t val);
+    uint16_t length() { return E2END + 1; }
+
+    template <typename T>
+    T& get(int idx, T& t)
+    {
+        uint8_t* p = (uint8_t*)&t;
+        for (unsigned i = 0; i < sizeof(T); i++) p[i] = read(idx + i);
+        return t;
+    }
+
+    template <typename T>
+    const T& put(int idx, const T& t)
+    {
+        const uint8_t* p = (const uint8_t*)&t;
+        for (unsigned i = 0; i < sizeof(T); i++) update(idx + i, p[i]);
+        return t;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __SIM_LIQUID_CRYSTAL_I2C__
+#define __SIM_LIQUID_CRYSTAL_I2C__
+
+#include <Arduino.h>
+
+/** @brief Virtual time of one character or cursor move over I2C (us), as LCD_WRITE_US. */
+#define SIM_LCD_WRITE_US 1300
+
+/** @brief Virtual time of a clear or home command (us). */
+#define SIM_LCD_CLEAR_US 2000
+
+/**
+ * @brief HD44780 behind a PCF8574, simulated as a character grid.
+ *
+ * The LCD class runs unchanged on top of it; each command costs the
+ * virtual time of its I2C transfer. SimLcd reads the glass.
+ */
+class LiquidCrystal_I2C : public Print
+{
+   private:
+    uint8_t cols, rows;
+    uint8_t col, row;
+    char glass[4][40];
+    unsigned long writes; /**< Characters and commands sent */
+
+   public:
+    LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows);
+    void init();
+    void begin(uint8_t, uint8_t) { init(); }
+    void backlight() {}
+    void noBacklight() {}
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    /** @brief Row of the glass, cols characters, not terminated. */
+    const char* line(uint8_t r) const { return glass[r]; }
+    uint8_t getCols() const { return cols; }
+    uint8_t getRows() const { return rows; }
+    unsigned long getWrites() const { return writes; }
+
+    /** @brief Last display created, for SimLcd. */
+    static LiquidCrystal_I2C* instance;
+};
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __SIM_MEMORY_FREE__
+#define __SIM_MEMORY_FREE__
+
+/** @brief No heap limit on the host, always 0. */
+int freeMemory();
+
+#endif
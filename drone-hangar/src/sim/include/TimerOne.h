@@ -0,0 +1,18 @@
+#ifndef __SIM_TIMER_ONE__
+#define __SIM_TIMER_ONE__
+
+/**
+ * @brief Timer1 periodic interrupt, fired by SimClock.
+ */
+class TimerOne
+{
+   public:
+    void initialize(long microseconds);
+    void setPeriod(long microseconds);
+    void attachInterrupt(void (*isr)());
+    void detachInterrupt();
+};
+
+extern TimerOne Timer1;
+
+#endif
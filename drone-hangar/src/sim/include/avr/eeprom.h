@@ -0,0 +1,9 @@
+#ifndef __SIM_AVR_EEPROM__
+#define __SIM_AVR_EEPROM__
+
+#include <stdint.h>
+
+/** @brief false for 3.3 ms after each EEPROM write, like the real cell. */
+bool eeprom_is_ready();
+
+#endif
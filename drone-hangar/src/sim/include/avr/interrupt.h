@@ -0,0 +1,13 @@
+#ifndef __SIM_AVR_INTERRUPT__
+#define __SIM_AVR_INTERRUPT__
+
+#include "avr/io.h"
+
+/* A handler is a plain function, SimClock calls the ones it simulates */
+#define ISR(vector) extern "C" void vector(void)
+
+/* One thread, interrupts only run where the virtual clock advances */
+#define cli()
+#define sei()
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __SIM_AVR_IO__
+#define __SIM_AVR_IO__
+
+#include <stdint.h>
+
+/*
+ * ATmega328P registers used by the firmware, as plain variables. Writing
+ * them has no effect except TIMSK0 (OCIE0A), which SimClock checks before
+ * calling the Timer0 compare A interrupt. digitalWrite() and analogWrite()
+ * update the port and Timer0 B registers like the AVR core, and SimLight
+ * reads its level back from them.
+ */
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2;
+extern volatile uint8_t TCCR0A, TCNT0, OCR0A, OCR0B, TIMSK0;
+extern volatile uint8_t PINB, PINC, PIND, PORTB, PORTC, PORTD;
+extern volatile uint8_t PCICR, PCIFR, PCMSK0, EIMSK, SREG;
+
+#define _BV(bit) (1 << (bit))
+
+#define CS21 1
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOV2 0
+#define OCF2A 1
+#define OCF2B 2
+#define TOIE0 0
+#define OCIE0A 1
+#define COM0B1 5
+#define PCIE0 0
+#define E2END 0x3FF
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef __SIM_AVR_PGMSPACE__
+#define __SIM_AVR_PGMSPACE__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+/* One address space: flash data is ordinary const data */
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(const void* const*)(addr))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define snprintf_P snprintf
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __SIM_AVR_SLEEP__
+#define __SIM_AVR_SLEEP__
+
+#define SLEEP_MODE_IDLE 0
+
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_disable()
+
+/** @brief Jumps the virtual clock to the next interrupt. */
+void sleep_cpu();
+
+#endif
@@ -0,0 +1,93 @@
+#include "task/AcquisitionTask.hpp"
+
+#include "config.hpp"
+#include "kernel/InputEvents.hpp"
+#include "kernel/Logger.hpp"
+#include "kernel/Trace.hpp"
+
+AcquisitionTask::AcquisitionTask(HWPlatform* pHW, Context* pContext)
+{
+    this->pHW = pHW;
+    this->pContext = pContext;
+    memset(&this->readings, 0, sizeof(this->readings));
+    this->readings.presence = pHW->getPresenceSensor()->isDetected();
+    this->readings.buttonDown = pHW->getButton()->isPressed();
+    this->tick();  // tasks never see a reading that was not taken
+}
+
+const SensorReadings* AcquisitionTask::getReadings() const { return &this->readings; }
+
+bool AcquisitionTask::isDue(unsigned long now, unsigned long at, unsigned long period)
+{
+    return at == 0 || now - at >= period;
+}
+
+void AcquisitionTask::drainEvents()
+{
+    InputEvent event;
+    while (InputEvents.pop(event))
+    {
+        switch (event.type)
+        {
+            case INPUT_PIR_RISE:
+            case INPUT_PIR_FALL:
+                readings.presence = event.type == INPUT_PIR_RISE;
+                readings.presenceAt = event.time;
+                Trace.sample(TRACE_PIR, event.time, readings.presence);
+                break;
+
+            case INPUT_BUTTON_DOWN:
+                readings.buttonDown = true;
+                readings.buttonPresses++;
+                readings.buttonAt = event.time;
+                Trace.sample(TRACE_BUTTON, event.time, 1);
+                break;
+
+            case INPUT_BUTTON_UP:
+                readings.buttonDown = false;
+                readings.buttonAt = event.time;
+                Trace.sample(TRACE_BUTTON, event.time, 0);
+                break;
+        }
+    }
+}
+
+void AcquisitionTask::tick()
+{
+    unsigned long now = millis();
+    if (now == 0)
+        now = 1;  // 0 means never sampled
+
+    pHW->getButton()->isPressed();  // resyncs an edge lost to the debounce
+    this->drainEvents();
+
+    if (!readings.pirReady && pHW->getPresenceSensor()->isReady())
+    {
+        readings.pirReady = true;
+        readings.presence = pHW->getPresenceSensor()->isDetected();
+        Logger.log(LOG_PIR_READY);
+    }
+    pContext->setPir(readings.presence);
+    pContext->setPirReady(readings.pirReady);
+
+    if (isDue(now, readings.temperatureAt, TEMP_SAMPLE_PERIOD))
+    {
+        readings.temperature = pHW->getTempSensor()->getTemperature();
+        readings.temperatureAt = now;
+        Trace.sample(TRACE_TEMP, now, lround(readings.temperature * 100));
+    }
+
+    // The sonar blocks for up to an echo timeout, only fire it when needed
+    if (!pContext->landingCheckRequested() && !pContext->takeoffCheckRequested())
+    {
+        readings.hasDistance = false;
+        readings.distanceAt = 0;
+    }
+    else if (isDue(now, readings.distanceAt, SONAR_SAMPLE_PERIOD))
+    {
+        readings.distance = pHW->getProximitySensor()->getDistance();
+        readings.hasDistance = true;
+        readings.distanceAt = now;
+        Trace.sample(TRACE_DISTANCE, now, lround(readings.distance * 1000));
+    }
+}
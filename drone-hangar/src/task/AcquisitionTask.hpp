@@ -0,0 +1,52 @@
+#ifndef __ACQUISITION_TASK__
+#define __ACQUISITION_TASK__
+
+#include "kernel/Task.hpp"
+#include "model/Context.hpp"
+#include "model/HWPlatform.hpp"
+#include "model/SensorReadings.hpp"
+
+/**
+ * @brief Task that samples the input devices into SensorReadings.
+ *
+ * Registered first, so every other task of the slot sees the readings of
+ * this slot. The PIR and button edges come from InputEvents (interrupts);
+ * the other devices are read in a fixed order (temperature, sonar), each
+ * at its own rate (see config.hpp). The sonar is only fired while a
+ * landing or takeoff check is requested.
+ */
+class AcquisitionTask : public Task
+{
+   private:
+    HWPlatform* pHW;
+    Context* pContext;
+    SensorReadings readings;
+
+    /** true if a sample taken at "at" is older than "period" (or missing). */
+    static bool isDue(unsigned long now, unsigned long at, unsigned long period);
+
+    /** Applies the queued PIR and button edges. */
+    void drainEvents();
+
+   public:
+    /**
+     * @brief Construct a new AcquisitionTask object
+     *
+     * @param pHW the hardware platform to sample
+     * @param pContext the system context (landing/takeoff check requests)
+     */
+    AcquisitionTask(HWPlatform* pHW, Context* pContext);
+
+    /**
+     * @brief Readings shared with the other tasks.
+     */
+    const SensorReadings* getReadings() const;
+
+    /**
+     * @brief Task execution method called by the scheduler when the task runs.
+     * Samples the devices that are due.
+     */
+    void tick() override;
+};
+
+#endif  // __ACQUISITION_TASK__
@@ -3,12 +3,15 @@
 #include <Arduino.h>
 
 #include "config.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
+#include "kernel/Params.hpp"
 
-DistanceTask::DistanceTask(ProximitySensor* sonarSensor, Context* pContext)
+DistanceTask::DistanceTask(const SensorReadings* readings, Context* pContext)
 {
-    this->sonarSensor = sonarSensor;
+    this->readings = readings;
     this->pContext = pContext;
+    this->state = IDLE;  // initial state, not journaled
     this->setState(IDLE);
 }
 
@@ -19,7 +22,7 @@ void DistanceTask::tick()
         case IDLE:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[DISTANCE] IDLE"));
+                Logger.log(LOG_DISTANCE_IDLE);
                 this->pContext->setDistance(-1);  // Indicate no reading
             }
             if (this->pContext->landingCheckRequested())
@@ -35,11 +38,9 @@ void DistanceTask::tick()
         case LANDING_MONITORING:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[DISTANCE] LANDING MONITORING"));
+                Logger.log(LOG_DISTANCE_LANDING_MONITORING);
             }
-            distance = sonarSensor->getDistance();
-            this->pContext->setDistance(distance);
-            if (distance <= D2)
+            if (readDistance() && distance <= Params.get(PARAM_D2) / 1000.0f)
             {
                 setState(LANDING_WAITING);
             }
@@ -52,16 +53,15 @@ void DistanceTask::tick()
         case LANDING_WAITING:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[DISTANCE] LANDING WAITING"));
+                Logger.log(LOG_DISTANCE_LANDING_WAITING, (int16_t)(distance * 1000));
             }
-            distance = sonarSensor->getDistance();
-            this->pContext->setDistance(distance);
-            if (distance > D2)
+            if (readDistance() && distance > Params.get(PARAM_D2) / 1000.0f)
             {
                 setState(LANDING_MONITORING);
             }
 
-            if (this->elapsedTimeInState() > TIME2 || !pContext->landingCheckRequested())
+            if (this->elapsedTimeInState() > Params.get(PARAM_TIME2) ||
+                !pContext->landingCheckRequested())
             {
                 this->pContext->setDroneIn(true);
                 this->pContext->closeLandingCheck();
@@ -72,11 +72,9 @@ void DistanceTask::tick()
         case TAKEOFF_MONITORING:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[DISTANCE] TAKEOFF MONITORING"));
+                Logger.log(LOG_DISTANCE_TAKEOFF_MONITORING);
             }
-            distance = sonarSensor->getDistance();
-            this->pContext->setDistance(distance);
-            if (distance >= D1)
+            if (readDistance() && distance >= Params.get(PARAM_D1) / 1000.0f)
             {
                 setState(TAKEOFF_WAITING);
             }
@@ -89,15 +87,14 @@ void DistanceTask::tick()
         case TAKEOFF_WAITING:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[DISTANCE] TAKEOFF WAITING"));
+                Logger.log(LOG_DISTANCE_TAKEOFF_WAITING, (int16_t)(distance * 1000));
             }
-            distance = sonarSensor->getDistance();
-            this->pContext->setDistance(distance);
-            if (distance < D1)
+            if (readDistance() && distance < Params.get(PARAM_D1) / 1000.0f)
             {
                 setState(TAKEOFF_MONITORING);
             }
-            if (this->elapsedTimeInState() > TIME1 || !pContext->takeoffCheckRequested())
+            if (this->elapsedTimeInState() > Params.get(PARAM_TIME1) ||
+                !pContext->takeoffCheckRequested())
             {
                 this->pContext->setDroneIn(false);
                 this->pContext->closeTakeoffCheck();
@@ -109,11 +106,24 @@ void DistanceTask::tick()
 
 void DistanceTask::setState(State state)
 {
+    if (state != this->state)
+    {
+        Journal.record(JOURNAL_DISTANCE, this->state, state);
+    }
     this->state = state;
     this->stateTimestamp = millis();
     this->justEntered = true;
 }
 
+bool DistanceTask::readDistance()
+{
+    if (!readings->hasDistance)
+        return false;
+    distance = readings->distance;
+    this->pContext->setDistance(distance);
+    return true;
+}
+
 long DistanceTask::elapsedTimeInState() { return millis() - stateTimestamp; }
 
 bool DistanceTask::checkAndSetJustEntered()
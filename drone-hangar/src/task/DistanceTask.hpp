@@ -3,14 +3,14 @@
 
 #include <Arduino.h>
 
-#include "devices/Sonar.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
+#include "model/SensorReadings.hpp"
 
 class DistanceTask : public Task
 {
    private:
-    ProximitySensor* sonarSensor;
+    const SensorReadings* readings;
     Context* pContext;
     float distance;
 
@@ -31,8 +31,11 @@ class DistanceTask : public Task
     void log(const String& msg);
     bool checkAndSetJustEntered();
 
+    /** Takes the sonar reading of the slot, false if there is none yet. */
+    bool readDistance();
+
    public:
-    DistanceTask(ProximitySensor* sonarSensor, Context* pContext);
+    DistanceTask(const SensorReadings* readings, Context* pContext);
     void tick();
 };
 
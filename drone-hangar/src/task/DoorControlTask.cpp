@@ -1,7 +1,9 @@
 #include "task/DoorControlTask.hpp"
 
 #include "config.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
+#include "kernel/Params.hpp"
 
 DoorControlTask::DoorControlTask(Context* ctx, ServoMotor* motor)
 {
@@ -9,11 +11,25 @@ DoorControlTask::DoorControlTask(Context* ctx, ServoMotor* motor)
     this->pDoorMotor = motor;
     this->currentPos = 0;
     this->pDoorMotor->setPosition(this->currentPos);
+    this->state = CLOSED;  // initial state, not journaled
     this->setState(CLOSED);
 }
 
 void DoorControlTask::tick()
 {
+    // A transition runs the new state's entry actions in the same tick, so a
+    // command does not pay one extra period per state it goes through
+    uint8_t steps = 0;
+    do
+    {
+        this->step();
+    } while (this->justEntered && ++steps < FSM_MAX_STEPS_PER_TICK);
+}
+
+void DoorControlTask::step()
+{
+    int openAngle = Params.get(PARAM_DOOR_OPEN_ANGLE);
+
     switch (this->state)
     {
         case CLOSED:
@@ -21,7 +37,7 @@ void DoorControlTask::tick()
             if (this->checkAndSetJustEntered())
             {
                 this->pContext->setDoorClosed();
-                Logger.log(F("[DOOR] CLOSED"));
+                Logger.log(LOG_DOOR_CLOSED);
             }
 
             if (this->pContext->openDoorReq())
@@ -35,15 +51,19 @@ void DoorControlTask::tick()
         {
             if (this->checkAndSetJustEntered())
             {
-                Logger.log(F("[DOOR] OPENING"));
+                Logger.log(LOG_DOOR_OPENING);
+                if (this->pContext->getCommandStamp())
+                {
+                    // Command to actuation: RX of the command to the first servo update
+                    unsigned long us = micros() - this->pContext->getCommandStamp();
+                    Logger.log(LOG_CMD_LATENCY, (int16_t)min(us / 1000, 32767UL));
+                    this->pContext->stampCommand(0);
+                }
+                this->moveDoor(openAngle);
             }
 
-            long dt = this->elapsedTimeInState();
-            if (dt > MOVING_TIME)
-                dt = MOVING_TIME;
-
-            this->currentPos = ((float)dt / MOVING_TIME) * DOOR_OPEN_ANGLE;
-            this->pDoorMotor->setPosition(this->currentPos);
+            this->currentPos = this->pDoorMotor->getPosition();
+            this->pContext->setDoorAngle(this->currentPos);
 
             if (this->pContext->closeDoorReq())
             {
@@ -61,7 +81,7 @@ void DoorControlTask::tick()
             if (this->checkAndSetJustEntered())
             {
                 this->pContext->setDoorOpened();
-                Logger.log(F("[DOOR] OPEN"));
+                Logger.log(LOG_DOOR_OPEN);
             }
 
             if (this->pContext->closeDoorReq())
@@ -75,17 +95,18 @@ void DoorControlTask::tick()
         {
             if (this->checkAndSetJustEntered())
             {
-                Logger.log(F("[DOOR] CLOSING"));
+                Logger.log(LOG_DOOR_CLOSING);
+                this->moveDoor(0);
             }
 
-            long dt = this->elapsedTimeInState();
-            if (dt > MOVING_TIME)
-                dt = MOVING_TIME;
-
-            this->currentPos = DOOR_OPEN_ANGLE - ((float)dt / MOVING_TIME) * DOOR_OPEN_ANGLE;
-            this->pDoorMotor->setPosition(this->currentPos);
+            this->currentPos = this->pDoorMotor->getPosition();
+            this->pContext->setDoorAngle(this->currentPos);
 
-            if (this->isDoorClosed())
+            if (this->pContext->openDoorReq())
+            {
+                this->setState(OPENING);  // reverse from where the door is
+            }
+            else if (this->isDoorClosed())
             {
                 this->setState(CLOSED);
             }
@@ -94,11 +115,27 @@ void DoorControlTask::tick()
     }
 }
 
-bool DoorControlTask::isDoorOpen() { return this->currentPos == DOOR_OPEN_ANGLE; }
-bool DoorControlTask::isDoorClosed() { return this->currentPos == 0; }
+void DoorControlTask::moveDoor(int angle)
+{
+    // The travel time follows the angle left, so a reversal mid-way does
+    // not replay a full move
+    long movingTime = Params.get(PARAM_MOVING_TIME);
+    long travel = abs(angle - this->pDoorMotor->getPosition());
+    this->pDoorMotor->moveTo(angle, movingTime * travel / Params.get(PARAM_DOOR_OPEN_ANGLE));
+}
+
+bool DoorControlTask::isDoorOpen()
+{
+    return !this->pDoorMotor->isMoving() && this->currentPos == Params.get(PARAM_DOOR_OPEN_ANGLE);
+}
+bool DoorControlTask::isDoorClosed() { return !this->pDoorMotor->isMoving() && this->currentPos == 0; }
 
 void DoorControlTask::setState(State state)
 {
+    if (state != this->state)
+    {
+        Journal.record(JOURNAL_DOOR, this->state, state);
+    }
     this->state = state;
     this->stateTimestamp = millis();
     this->justEntered = true;
@@ -9,6 +9,10 @@
 
 /**
  * Task responsible for controlling the hangar door using a servo motor.
+ *
+ * The task only posts the target of a move; the servo driver generates the
+ * motion frame by frame and the task reads the position back. OPENING and
+ * CLOSING reverse into each other from the current position.
  */
 class DoorControlTask : public Task
 {
@@ -32,11 +36,16 @@ class DoorControlTask : public Task
     bool justEntered;
     int currentPos;
 
+    /** Runs the FSM once, tick() repeats it after a transition. */
+    void step();
     void setState(State state);
     long elapsedTimeInState();
     void log(const char* msg);
     bool checkAndSetJustEntered();
 
+    /** Moves the door from its current position, in a time proportional to the angle. */
+    void moveDoor(int angle);
+
     bool isDoorOpen();
     bool isDoorClosed();
 
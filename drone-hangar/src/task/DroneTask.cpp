@@ -1,19 +1,29 @@
 #include "task/DroneTask.hpp"
 
 #include "config.hpp"
-#include "devices/Led.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
 
-DroneTask::DroneTask(Context* pContext, Light* L1, PresenceSensor* presenceSensor)
+DroneTask::DroneTask(Context* pContext, const SensorReadings* readings)
 {
     this->pContext = pContext;
-    this->L1 = L1;
-    this->presenceSensor = presenceSensor;
+    this->readings = readings;
+    this->state = REST;  // initial state, not journaled
     this->setState(REST);
-    L1->switchOn();
 }
 
 void DroneTask::tick()
+{
+    // A transition runs the new state's entry actions in the same tick, so a
+    // command does not pay one extra period per state it goes through
+    uint8_t steps = 0;
+    do
+    {
+        this->step();
+    } while (this->justEntered && ++steps < FSM_MAX_STEPS_PER_TICK);
+}
+
+void DroneTask::step()
 {
     switch (this->state)
     {
@@ -23,12 +33,12 @@ void DroneTask::tick()
                 pContext->setDroneState(REST);
                 pContext->closeDoor();
                 pContext->stopBlink();
-                Logger.log(F("[Drone] REST"));
+                Logger.log(LOG_DRONE_REST);
             }
 
             if (!pContext->isAlarmActive())
             {
-                pContext->setLCDMessage(LCD_REST_STATE);
+                pContext->setLCDMessage(MSG_REST);
             }
 
             if (pContext->consumeCommand(CommandType::OPEN) &&
@@ -44,9 +54,9 @@ void DroneTask::tick()
                 pContext->setDroneState(TAKING_OFF);
                 pContext->openDoor();
                 pContext->requestTakeoffCheck();
-                pContext->setLCDMessage(LCD_TAKING_OFF_STATE);
+                pContext->setLCDMessage(MSG_TAKING_OFF);
                 pContext->blink();
-                Logger.log(F("[Drone] TAKING OFF"));
+                Logger.log(LOG_DRONE_TAKING_OFF);
             }
 
             if (pContext->isAlarmActive() && pContext->isDroneIn())
@@ -66,17 +76,18 @@ void DroneTask::tick()
                 pContext->setDroneState(OPERATING);
                 pContext->closeDoor();
                 pContext->stopBlink();
-                Logger.log(F("[Drone] OPERATING"));
+                Logger.log(LOG_DRONE_OPERATING);
             }
 
             if (!pContext->isAlarmActive())
             {
-                pContext->setLCDMessage(LCD_OPERATING_STATE);
+                pContext->setLCDMessage(MSG_OPERATING);
             }
 
-            if (pContext->consumeCommand(CommandType::OPEN) &&
-                !(pContext->isPreAlarmActive() || pContext->isAlarmActive()) &&
-                presenceSensor->isDetected())
+            // While the PIR warms up the OPEN command is left pending (until
+            // its TTL): presence cannot be checked yet
+            if (readings->pirReady && pContext->consumeCommand(CommandType::OPEN) &&
+                !(pContext->isPreAlarmActive() || pContext->isAlarmActive()) && readings->presence)
             {
                 setState(LANDING);
             }
@@ -88,9 +99,9 @@ void DroneTask::tick()
                 pContext->setDroneState(LANDING);
                 pContext->openDoor();
                 pContext->requestLandingCheck();
-                pContext->setLCDMessage(LCD_LANDING_STATE);
+                pContext->setLCDMessage(MSG_LANDING);
                 pContext->blink();
-                Logger.log(F("[Drone] LANDING"));
+                Logger.log(LOG_DRONE_LANDING);
             }
 
             if (pContext->isAlarmActive() && !pContext->isDroneIn())
@@ -108,6 +119,10 @@ void DroneTask::tick()
 
 void DroneTask::setState(State state)
 {
+    if (state != this->state)
+    {
+        Journal.record(JOURNAL_DRONE, this->state, state);
+    }
     this->state = state;
     this->stateTimestamp = millis();
     this->justEntered = true;
@@ -3,13 +3,11 @@
 
 #include <Arduino.h>
 
-#include "devices/Led.hpp"
-#include "devices/PresenceSensor.hpp"
 #include "devices/ServoMotor.hpp"
 #include "kernel/MsgService.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
-#include "task/BlinkingTask.hpp"
+#include "model/SensorReadings.hpp"
 
 /**
  * @brief Task that manages the drone operations.
@@ -30,9 +28,10 @@ class DroneTask : public Task
 
     long stateTimestamp;
     bool justEntered;
-    Light* L1;
-    PresenceSensor* presenceSensor;
+    const SensorReadings* readings;
 
+    /** Runs the FSM once, tick() repeats it after a transition. */
+    void step();
     void setState(State state);
     long elapsedTimeInState();
     void log(const String& msg);
@@ -45,10 +44,9 @@ class DroneTask : public Task
      * @brief Construct a new Drone Task object
      *
      * @param pContext Pointer to the shared context object
-     * @param L1 Pointer to the Light device
-     * @param presenceSensor Pointer to the Presence Sensor device
+     * @param readings Sensor readings of the slot (presence)
      */
-    DroneTask(Context* pContext, Light* L1, PresenceSensor* presenceSensor);
+    DroneTask(Context* pContext, const SensorReadings* readings);
 
     /**
      * @brief Task execution method called by the scheduler when the task runs.
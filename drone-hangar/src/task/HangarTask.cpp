@@ -1,15 +1,21 @@
 #include "task/HangarTask.hpp"
 
 #include "config.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
+#include "kernel/Params.hpp"
 
-HangarTask::HangarTask(TempSensor* tempSensor, Button* resetButton, Light* L3, Context* pContext)
-    : tempSensor(tempSensor), resetButton(resetButton), L3(L3), pContext(pContext), state(NORMAL)
+HangarTask::HangarTask(const SensorReadings* readings, Context* pContext)
+    : readings(readings), pContext(pContext), seenPresses(readings->buttonPresses), state(NORMAL)
 {
 }
 
 void HangarTask::tick()
 {
+    // Presses since the last tick, only meaningful in ALARM
+    bool pressed = readings->buttonPresses != seenPresses;
+    seenPresses = readings->buttonPresses;
+
     switch (state)
     {
         case NORMAL:
@@ -17,23 +23,24 @@ void HangarTask::tick()
             {
                 pContext->setPreAlarm(false);
                 pContext->setAlarm(false);
-                L3->switchOff();
-                Logger.log(F("[HT] NORMAL"));
+                Logger.log(LOG_HT_NORMAL);
             }
-            this->temperature = tempSensor->getTemperature();
-            if (temperature >= TEMP1)
+            this->temperature = readings->temperature;
+            pContext->setTemperature(this->temperature);
+            if (temperature >= Params.get(PARAM_TEMP1))
                 setState(TRACKING_PRE_ALARM);
             break;
 
         case TRACKING_PRE_ALARM:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[HT] TRACKING PRE-ALARM"));
+                Logger.log(LOG_HT_TRACKING_PRE_ALARM, (int16_t)temperature);
             }
-            this->temperature = tempSensor->getTemperature();
-            if (temperature < TEMP1)
+            this->temperature = readings->temperature;
+            pContext->setTemperature(this->temperature);
+            if (temperature < Params.get(PARAM_TEMP1))
                 setState(NORMAL);
-            else if (elapsedTimeInState() >= TIME3)
+            else if (elapsedTimeInState() >= Params.get(PARAM_TIME3))
                 setState(PREALARM);
             break;
 
@@ -41,24 +48,26 @@ void HangarTask::tick()
             if (checkAndSetJustEntered())
             {
                 pContext->setPreAlarm(true);
-                Logger.log(F("[HT] PREALARM ACTIVE"));
+                Logger.log(LOG_HT_PREALARM, (int16_t)temperature);
             }
-            this->temperature = tempSensor->getTemperature();
-            if (temperature < TEMP1)
+            this->temperature = readings->temperature;
+            pContext->setTemperature(this->temperature);
+            if (temperature < Params.get(PARAM_TEMP1))
                 setState(NORMAL);
-            else if (temperature >= TEMP2)
+            else if (temperature >= Params.get(PARAM_TEMP2))
                 setState(TRACKING_ALARM);
             break;
 
         case TRACKING_ALARM:
             if (checkAndSetJustEntered())
             {
-                Logger.log(F("[HT] TRACKING ALARM"));
+                Logger.log(LOG_HT_TRACKING_ALARM, (int16_t)temperature);
             }
-            this->temperature = tempSensor->getTemperature();
-            if (temperature < TEMP2)
+            this->temperature = readings->temperature;
+            pContext->setTemperature(this->temperature);
+            if (temperature < Params.get(PARAM_TEMP2))
                 setState(PREALARM);
-            else if (elapsedTimeInState() >= TIME4)
+            else if (elapsedTimeInState() >= Params.get(PARAM_TIME4))
                 setState(ALARM);
             break;
 
@@ -67,11 +76,10 @@ void HangarTask::tick()
             {
                 pContext->setPreAlarm(false);
                 pContext->setAlarm(true);
-                L3->switchOn();
-                pContext->setLCDMessage(LCD_ALARM_STATE);
-                Logger.log(F("[HT] ALARM"));
+                pContext->setLCDMessage(MSG_ALARM);
+                Logger.log(LOG_HT_ALARM, (int16_t)temperature);
             }
-            if (resetButton->isPressed())
+            if (pressed || pContext->consumeCommand(CommandType::RESET_ALARM))
                 setState(NORMAL);
             break;
     }
@@ -79,6 +87,10 @@ void HangarTask::tick()
 
 void HangarTask::setState(State newState)
 {
+    if (newState != this->state)
+    {
+        Journal.record(JOURNAL_HANGAR, this->state, newState);
+    }
     state = newState;
     stateTimestamp = millis();
     justEntered = true;
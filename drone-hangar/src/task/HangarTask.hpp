@@ -3,23 +3,20 @@
 
 #include <Arduino.h>
 
-#include "devices/Button.hpp"
-#include "devices/Light.hpp"
-#include "devices/TempSensor.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
+#include "model/SensorReadings.hpp"
 
 class HangarTask : public Task
 {
    private:
-    TempSensor* tempSensor;
-    Button* resetButton;
-    Light* L3;
+    const SensorReadings* readings;
     Context* pContext;
 
     uint32_t stateTimestamp;
     bool justEntered;
     float temperature;
+    uint8_t seenPresses; /**< readings->buttonPresses at the previous tick */
 
     enum State
     {
@@ -35,7 +32,7 @@ class HangarTask : public Task
     bool checkAndSetJustEntered();
 
    public:
-    HangarTask(TempSensor* tempSensor, Button* resetButton, Light* L3, Context* pContext);
+    HangarTask(const SensorReadings* readings, Context* pContext);
     void tick() override;
 };
 
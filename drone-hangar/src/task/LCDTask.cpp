@@ -6,16 +6,22 @@ LCDTask::LCDTask(LCD* lcd, Context* pContext)
 {
     this->lcd = lcd;
     this->pContext = pContext;
-    this->lastMsg[0] = '\0';  // Initialize lastMsg as empty string
+    this->lastMsg = MSG_NONE;  // the glass starts blank
 }
 
 void LCDTask::tick()
 {
-    const char* msg = this->pContext->getLCDMessage();
-    if (strcmp(msg, this->lastMsg) != 0)
+    const ContextSnapshot& snap = this->pContext->getSnapshot();
+    if (snap.lcdMessage != this->lastMsg)
     {
-        this->lcd->print(msg);
-        strncpy(this->lastMsg, msg, sizeof(this->lastMsg) - 1);
-        this->lastMsg[sizeof(this->lastMsg) - 1] = '\0';
+        this->lcd->show(snap.lcdMessage, DASH_MESSAGE_ROWS);
+        this->lastMsg = snap.lcdMessage;
     }
+    this->dashboard.update(millis(), snap, this->lcd);
+
+    unsigned long budget = this->getBudget();
+    if (budget > LCD_FLUSH_MAX_US)
+        budget = LCD_FLUSH_MAX_US;
+    if (!this->lcd->flush(budget))
+        this->wake();  // finish in the next slots, not the next period
 }
@@ -4,18 +4,21 @@
 #include "devices/LCD.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
+#include "model/Dashboard.hpp"
 
 /**
  * @brief Task to manage the LCD display.
  *
- * This task periodically updates the LCD with relevant information from the system context.
+ * This task periodically updates the LCD with relevant information from the system context:
+ * the status message on the top row and the live dashboard fields below it.
  */
 class LCDTask : public Task
 {
    private:
     Context* pContext;
     LCD* lcd;
-    char lastMsg[LCD_BUFFER_SIZE];
+    MessageId lastMsg;
+    Dashboard dashboard;
 
    public:
     /**
@@ -28,7 +31,9 @@ class LCDTask : public Task
 
     /**
      * @brief Task execution method called by the scheduler when the task runs.
-     * Updates the LCD display if the message has changed.
+     * Lays out the message if it has changed and the dashboard fields that
+     * are due, then flushes what fits in the budget (at most
+     * LCD_FLUSH_MAX_US); runs every slot until everything is shown.
      */
     void tick() override;
 };
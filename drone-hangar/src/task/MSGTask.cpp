@@ -1,26 +1,81 @@
 #include "task/MSGTask.hpp"
 
 #include <Arduino.h>
+#include <MemoryFree.h>
 
 #include "config.hpp"
+#include "kernel/BinaryProtocol.hpp"
+#include "kernel/InputEvents.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/Logger.hpp"
 #include "kernel/MsgService.hpp"
 #include "model/Context.hpp"
 
-MsgTask::MsgTask(Context* pContext, MsgServiceClass* pMsgService)
+static char commonBuf[128];
+static StaticJsonDocument<128> jsonDoc;
+static MsgTask* fastPathTask = nullptr;
+
+MsgTask::MsgTask(Context* pContext, MsgServiceClass* pMsgService, LCD* pLcd)
 {
     this->pContext = pContext;
     this->pMsgService = pMsgService;
+    this->pLcd = pLcd;
     this->lastJsonSent = millis();
+    this->nCommandListeners = 0;
+    this->journalExport = JOURNAL_CAPACITY + 1;
+    this->historySignal = HIST_SIGNALS;
+    this->historyMark = History.mark(HIST_1S);
+    this->historyExport = HISTORY_IDLE;
+    fastPathTask = this;
+    pMsgService->setFastPath(MsgTask::fastPath);
 }
 
-void MsgTask::tick()
+bool MsgTask::addCommandListener(Task* task)
+{
+    if (nCommandListeners >= MAX_COMMAND_LISTENERS)
+        return false;
+    commandListeners[nCommandListeners++] = task;
+    return true;
+}
+
+bool MsgTask::fastPath(const char* content, size_t len)
+{
+    if (!fastPathTask)
+        return false;
+    return fastPathTask->handleMsg(content, len, true);
+}
+
+void MsgTask::commandAccepted()
 {
-    static char commonBuf[128];
-    static StaticJsonDocument<128> jsonDoc;
+    this->pContext->stampCommand(this->pMsgService->getLastRxMicros() | 1);  // 0 means none
+    for (uint8_t i = 0; i < nCommandListeners; i++)
+    {
+        commandListeners[i]->wake();
+    }
+}
 
+void MsgTask::tick()
+{
     this->pContext->cleanupExpired(millis());
 
+    if (this->pContext->consumeCommand(CommandType::DUMP_LOG))
+    {
+        Logger.startDump();
+    }
+
+    if (this->pContext->consumeCommand(CommandType::STATS))
+    {
+        this->sendStats();
+    }
+
+    if (this->pContext->consumeCommand(CommandType::JOURNAL))
+    {
+        this->journalExport = 0;
+        this->journalMark = Journal.mark();
+    }
+    this->exportJournal();
+    this->exportHistory();
+
     if (this->pMsgService->isMsgAvailable())
     {
         Msg* msg = this->pMsgService->receiveMsg();
@@ -29,67 +84,450 @@ void MsgTask::tick()
             const String& content = msg->getContent();
             if (content.length() > 0)
             {
-                if (content.length() < sizeof(commonBuf))
-                {
-                    strcpy(commonBuf, content.c_str());
-                    char* jsonStart = strchr(commonBuf, '{');
-                    if (jsonStart)
-                    {
-                        jsonDoc.clear();
-                        DeserializationError err = deserializeJson(jsonDoc, jsonStart);
-                        if (err == DeserializationError::Ok)
-                        {
-                            if (jsonDoc.overflowed())
-                            {
-                                Logger.log(F("JSON_OVR"));
-                            }
-                            const char* cmd = jsonDoc[COMMAND];
-
-                            if (!cmd)
-                            {
-                                for (JsonPair kv : jsonDoc.as<JsonObject>())
-                                {
-                                    if (strcmp(kv.key().c_str(), COMMAND) == 0)
-                                    {
-                                        if (kv.value().is<const char*>())
-                                            cmd = kv.value().as<const char*>();
-                                        break;
-                                    }
-                                }
-                            }
-
-                            if (cmd)
-                            {
-                                bool result = this->pContext->tryEnqueueMsg(cmd);
-                                Logger.log(result ? F("CMD_OK") : F("CMD_ERR"));
-                            }
-                            else
-                            {
-                                Logger.log(F("CMD_NULL"));
-                            }
-                        }
-                        else
-                        {
-                            Logger.log(F("JSON_ERR"));
-                        }
-                    }
-                }
-                else
-                {
-                    Logger.log(F("MSG_OVR"));
-                }
+                this->handleMsg(content.c_str(), content.length(), false);
             }
         }
     }
 
     if (millis() - lastJsonSent >= JSON_UPDATE_PERIOD_MS)
     {
-        jsonDoc.clear();
-        this->pContext->serializeData(jsonDoc);
-        jsonDoc[ALIVE] = true;
-        serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
-
-        this->pMsgService->sendMsgRaw(commonBuf, true);
+        this->sendStatus();
         lastJsonSent = millis();
     }
 }
+
+bool MsgTask::handleMsg(const char* content, size_t len, bool commandsOnly)
+{
+    // Behind a message left for tick(), so the order is kept
+    if (commandsOnly && this->pMsgService->isMsgAvailable())
+        return false;
+
+    if (this->pMsgService->isBinaryMode())
+    {
+        return this->handleFrame(content, len, commandsOnly);
+    }
+    return this->handleJson(content, len, commandsOnly);
+}
+
+bool MsgTask::handleJson(const char* content, size_t len, bool commandsOnly)
+{
+    if (len >= sizeof(commonBuf))
+    {
+        Logger.log(LOG_MSG_OVR);
+        return true;
+    }
+
+    strcpy(commonBuf, content);
+    char* jsonStart = strchr(commonBuf, '{');
+    if (!jsonStart)
+        return true;
+
+    jsonDoc.clear();
+    DeserializationError err = deserializeJson(jsonDoc, jsonStart);
+    if (err != DeserializationError::Ok)
+    {
+        Logger.log(LOG_JSON_ERR);
+        return true;
+    }
+
+    if (commandsOnly && (jsonDoc.containsKey(PARAM_GET_KEY) || jsonDoc.containsKey(PARAM_SET_KEY) ||
+                         jsonDoc.containsKey(HIST_KEY) || jsonDoc.containsKey(LOG_MODULE_KEY)))
+        return false;
+
+    if (jsonDoc.overflowed())
+    {
+        Logger.log(LOG_JSON_OVR);
+    }
+
+    const char* proto = jsonDoc[PROTO_KEY];
+    if (proto)
+    {
+        this->negotiate(proto);
+        return true;
+    }
+
+    const char* getName = jsonDoc[PARAM_GET_KEY];
+    const char* setName = jsonDoc[PARAM_SET_KEY];
+    if (getName || setName)
+    {
+        ParamId id = Params.fromName(getName ? getName : setName);
+        bool result = id < PARAM_COUNT;
+        if (result && setName)
+        {
+            result = jsonDoc[PARAM_VALUE_KEY].is<unsigned int>() &&
+                     Params.set(id, jsonDoc[PARAM_VALUE_KEY].as<uint16_t>());
+            Logger.log(result ? LOG_CMD_OK : LOG_CMD_ERR);
+        }
+        if (result)
+            this->sendParam(id);
+        else if (getName)
+            Logger.log(LOG_CMD_ERR);
+        return true;
+    }
+
+    const char* signal = jsonDoc[HIST_KEY];
+    if (signal)
+    {
+        bool result = this->startHistory(History.signalFromName(signal), jsonDoc[HIST_RES_KEY] | 0);
+        Logger.log(result ? LOG_CMD_OK : LOG_CMD_ERR);
+        return true;
+    }
+
+    const char* module = jsonDoc[LOG_MODULE_KEY];
+    if (module)
+    {
+        bool result = jsonDoc[LOG_LEVEL_KEY].is<int>() &&
+                      Logger.setLevel(Logger.moduleFromName(module), jsonDoc[LOG_LEVEL_KEY].as<uint8_t>());
+        Logger.log(result ? LOG_CMD_OK : LOG_CMD_ERR);
+        return true;
+    }
+
+    const char* cmd = jsonDoc[COMMAND];
+
+    if (!cmd)
+    {
+        for (JsonPair kv : jsonDoc.as<JsonObject>())
+        {
+            if (strcmp(kv.key().c_str(), COMMAND) == 0)
+            {
+                if (kv.value().is<const char*>())
+                    cmd = kv.value().as<const char*>();
+                break;
+            }
+        }
+    }
+
+    if (cmd)
+    {
+        bool result = this->pContext->tryEnqueueMsg(cmd);
+        Logger.log(result ? LOG_CMD_OK : LOG_CMD_ERR);
+        if (result)
+            this->commandAccepted();
+    }
+    else
+    {
+        Logger.log(LOG_CMD_NULL);
+    }
+    return true;
+}
+
+void MsgTask::negotiate(const char* proto)
+{
+    bool binary = strcasecmp(proto, PROTO_BINARY) == 0;
+    if (!binary && strcasecmp(proto, PROTO_JSON) != 0)
+    {
+        Logger.log(LOG_PROTO_ERR);
+        return;
+    }
+
+    // The answer is the last JSON line, everything after it is framed
+    jsonDoc.clear();
+    jsonDoc[PROTO_KEY] = binary ? PROTO_BINARY : PROTO_JSON;
+    serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
+    this->pMsgService->sendMsgRaw(commonBuf, true);
+    this->pMsgService->setBinaryMode(binary);
+}
+
+bool MsgTask::handleFrame(const char* content, size_t len, bool commandsOnly)
+{
+    uint8_t raw[FRAME_MAX_SIZE + 1];
+    if (len > FRAME_MAX_ENCODED)
+    {
+        Logger.log(LOG_MSG_OVR);
+        return true;
+    }
+
+    len = cobsDecode((const uint8_t*)content, len, raw);
+    FrameReader reader(raw, len);
+    if (len == 0 || !reader.isValid())
+    {
+        Logger.log(LOG_FRAME_ERR);
+        return true;
+    }
+
+    uint8_t id, n;
+    uint32_t value;
+    const uint8_t* data;
+    if (commandsOnly)
+    {
+        FrameReader scan = reader;
+        while (scan.next(id, value, data, n))
+        {
+            if (reader.type() == FRAME_COMMAND && id != FIELD_CMD)
+                return false;
+        }
+    }
+
+    bool result = false;
+    bool switchToJson = false;
+    uint8_t logModule = LOG_MODULE_COUNT;
+    uint8_t paramId = PARAM_COUNT;
+    uint8_t histSignal = HIST_SIGNALS;
+    uint8_t histLevel = HIST_1S;
+    while (reader.next(id, value, data, n))
+    {
+        if (reader.type() == FRAME_COMMAND && id == FIELD_CMD)
+        {
+            result = this->pContext->tryEnqueueCommand((uint8_t)value);
+            if (result)
+                this->commandAccepted();
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_LOG_MODULE)
+        {
+            logModule = (uint8_t)value;
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_LOG_LEVEL)
+        {
+            result = Logger.setLevel((LogModule)logModule, (uint8_t)value);
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_PARAM_ID)
+        {
+            paramId = (uint8_t)value;
+            result = paramId < PARAM_COUNT;
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_PARAM_VALUE)
+        {
+            result = Params.set((ParamId)paramId, (uint16_t)value);
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_HIST_SIGNAL)
+        {
+            histSignal = (uint8_t)value;
+        }
+        else if (reader.type() == FRAME_COMMAND && id == FIELD_HIST_RES)
+        {
+            histLevel = (uint8_t)value;
+        }
+        else if (reader.type() == FRAME_HELLO && id == FIELD_PROTO)
+        {
+            result = true;
+            switchToJson = value == 0;
+        }
+    }
+
+    if (histSignal < HIST_SIGNALS)
+    {
+        result = this->startHistory(histSignal, histLevel);
+    }
+
+    FrameWriter writer(raw, sizeof(raw), FRAME_ACK, this->pMsgService->nextSeq());
+    writer.putU8(FIELD_ACK_SEQ, reader.seq());
+    writer.putU8(FIELD_RESULT, result ? 1 : 0);
+    this->pMsgService->sendFrame(raw, writer.finish());
+
+    if (result && paramId < PARAM_COUNT)
+    {
+        this->sendParam((ParamId)paramId);
+    }
+
+    if (switchToJson)
+    {
+        this->pMsgService->setBinaryMode(false);
+    }
+    return true;
+}
+
+void MsgTask::sendParam(ParamId id)
+{
+    if (this->pMsgService->isBinaryMode())
+    {
+        uint8_t frame[FRAME_MAX_SIZE];
+        FrameWriter writer(frame, sizeof(frame), FRAME_PARAM, this->pMsgService->nextSeq());
+        writer.putU8(FIELD_PARAM_ID, id);
+        writer.putU16(FIELD_PARAM_VALUE, Params.get(id));
+        this->pMsgService->sendFrame(frame, writer.finish());
+        return;
+    }
+
+    jsonDoc.clear();
+    jsonDoc[Params.nameOf(id)] = Params.get(id);
+    serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
+    this->pMsgService->sendMsgRaw(commonBuf, true);
+}
+
+void MsgTask::exportJournal()
+{
+    uint16_t delta;
+    uint8_t subsystem, states;
+
+    for (uint8_t sent = 0; sent < JOURNAL_EXPORT_PER_TICK && journalExport < JOURNAL_CAPACITY;)
+    {
+        if (Serial.availableForWrite() < JOURNAL_EXPORT_MIN_TX_FREE)
+            return;
+        if (!Journal.read(journalMark, journalExport++, delta, subsystem, states))
+            continue;
+        sent++;
+
+        if (this->pMsgService->isBinaryMode())
+        {
+            uint8_t record[4] = {(uint8_t)delta, (uint8_t)(delta >> 8), subsystem, states};
+            uint8_t frame[FRAME_MAX_SIZE];
+            FrameWriter writer(frame, sizeof(frame), FRAME_JOURNAL, this->pMsgService->nextSeq());
+            writer.putBytes(FIELD_JOURNAL, record, sizeof(record));
+            this->pMsgService->sendFrame(frame, writer.finish());
+        }
+        else
+        {
+            snprintf(commonBuf, sizeof(commonBuf), "jr:%u,%u,%u,%u", delta, subsystem, states >> 4, states & 0x0F);
+            this->pMsgService->sendMsgRaw(commonBuf, true);
+        }
+    }
+
+    if (journalExport == JOURNAL_CAPACITY)
+    {
+        // End marker, then back to idle
+        journalExport++;
+        if (this->pMsgService->isBinaryMode())
+        {
+            uint8_t frame[FRAME_MAX_SIZE];
+            FrameWriter writer(frame, sizeof(frame), FRAME_JOURNAL, this->pMsgService->nextSeq());
+            this->pMsgService->sendFrame(frame, writer.finish());
+        }
+        else
+        {
+            this->pMsgService->sendMsgRaw(F("jr:end"), true);
+        }
+    }
+}
+
+bool MsgTask::startHistory(uint8_t signal, uint8_t level)
+{
+    if (signal >= HIST_SIGNALS || level >= HIST_LEVELS)
+        return false;
+    this->historySignal = signal;
+    this->historyMark = History.mark((HistoryLevel)level);
+    this->historyExport = 0;
+    return true;
+}
+
+void MsgTask::exportHistory()
+{
+    if (historyExport == HISTORY_IDLE)
+        return;
+
+    int16_t min, max, avg;
+    for (uint8_t sent = 0; sent < HISTORY_EXPORT_PER_TICK; sent++)
+    {
+        if (Serial.availableForWrite() < HISTORY_EXPORT_MIN_TX_FREE)
+            return;
+
+        bool more = History.read((HistorySignal)historySignal, historyMark, historyExport, min, max, avg);
+        if (this->pMsgService->isBinaryMode())
+        {
+            uint8_t frame[FRAME_MAX_SIZE];
+            FrameWriter writer(frame, sizeof(frame), FRAME_HISTORY, this->pMsgService->nextSeq());
+            if (more)
+            {
+                uint8_t bucket[7] = {historyExport,       (uint8_t)min, (uint8_t)(min >> 8), (uint8_t)max,
+                                     (uint8_t)(max >> 8), (uint8_t)avg, (uint8_t)(avg >> 8)};
+                writer.putBytes(FIELD_HISTORY, bucket, sizeof(bucket));
+            }
+            this->pMsgService->sendFrame(frame, writer.finish());
+        }
+        else if (more)
+        {
+            snprintf(commonBuf, sizeof(commonBuf), "hs:%u,%d,%d,%d", historyExport, min, max, avg);
+            this->pMsgService->sendMsgRaw(commonBuf, true);
+        }
+        else
+        {
+            this->pMsgService->sendMsgRaw(F("hs:end"), true);
+        }
+
+        if (!more)
+        {
+            historyExport = HISTORY_IDLE;
+            return;
+        }
+        historyExport++;
+    }
+}
+
+void MsgTask::sendStats()
+{
+    const CommandStore& commands = this->pContext->getCommands();
+
+    if (this->pMsgService->isBinaryMode())
+    {
+        uint8_t frame[FRAME_MAX_SIZE];
+        FrameWriter writer(frame, sizeof(frame), FRAME_STATS, this->pMsgService->nextSeq());
+        writer.putU16(FIELD_CMD_OVR, commands.getOverflows());
+        writer.putU16(FIELD_CMD_EXP, commands.getExpired());
+        writer.putU16(FIELD_LOG_LOST, Logger.getLostCount());
+        writer.putU8(FIELD_IN_DROP, InputEvents.getDropped());
+        writer.putU16(FIELD_RAM_FREE, (uint16_t)freeMemory());
+        writer.putU8(FIELD_LCD_PENDING, this->pLcd->getPendingWrites());
+        writer.putU16(FIELD_LCD_LATENCY, this->pLcd->getLastLatency());
+        writer.putU16(FIELD_LCD_LAT_MAX, this->pLcd->getMaxLatency());
+        writer.putU16(FIELD_LCD_COAL, this->pLcd->getCoalesced());
+        this->pMsgService->sendFrame(frame, writer.finish());
+        return;
+    }
+
+    jsonDoc.clear();
+    JsonObject stats = jsonDoc.createNestedObject(STATS_KEY);
+    stats[STATS_CMD_OVR] = commands.getOverflows();
+    stats[STATS_CMD_EXP] = commands.getExpired();
+    stats[STATS_LOG_LOST] = Logger.getLostCount();
+    stats[STATS_IN_DROP] = InputEvents.getDropped();
+    stats[STATS_RAM_FREE] = freeMemory();
+    // An array keeps the longest reply within commonBuf
+    JsonArray lcd = stats.createNestedArray(STATS_LCD);
+    lcd.add(this->pLcd->getPendingWrites());
+    lcd.add(this->pLcd->getLastLatency());
+    lcd.add(this->pLcd->getMaxLatency());
+    lcd.add(this->pLcd->getCoalesced());
+    serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
+    this->pMsgService->sendMsgRaw(commonBuf, true);
+}
+
+void MsgTask::sendStatus()
+{
+#ifdef _PROTO_BENCH_
+    // Both encodings are built and decoded on every status so they can be compared on target.
+    unsigned long t0 = micros();
+    jsonDoc.clear();
+    this->pContext->serializeData(jsonDoc);
+    jsonDoc[ALIVE] = true;
+    size_t jsonLen = serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
+    unsigned long t1 = micros();
+    uint8_t benchFrame[FRAME_MAX_SIZE];
+    uint8_t benchEncoded[FRAME_MAX_ENCODED];
+    FrameWriter benchWriter(benchFrame, sizeof(benchFrame), FRAME_STATUS, 0);
+    this->pContext->serializeFrame(benchWriter);
+    benchWriter.putU8(FIELD_ALIVE, 1);
+    size_t binLen = cobsEncode(benchFrame, benchWriter.finish(), benchEncoded) + 1;
+    unsigned long t2 = micros();
+    // Decoded the way the commands are: parsed in place, then every field read
+    deserializeJson(jsonDoc, commonBuf);
+    uint8_t fields = 0;
+    for (JsonPair kv : jsonDoc.as<JsonObject>()) fields += !kv.value().isNull();
+    unsigned long t3 = micros();
+    FrameReader benchReader(benchFrame, cobsDecode(benchEncoded, binLen - 1, benchFrame));
+    uint8_t id, n;
+    uint32_t value;
+    const uint8_t* data;
+    bool valid = benchReader.isValid();
+    while (valid && benchReader.next(id, value, data, n)) fields--;
+    unsigned long t4 = micros();
+    Logger.log("bench json=" + String((int)jsonLen + 1) + "B/" + String((int)(t1 - t0)) + "/" +
+               String((int)(t3 - t2)) + "us bin=" + String((int)binLen) + "B/" + String((int)(t2 - t1)) + "/" +
+               String((int)(t4 - t3)) + "us fields=" + String((int)fields));
+#endif
+
+    if (this->pMsgService->isBinaryMode())
+    {
+        uint8_t frame[FRAME_MAX_SIZE];
+        FrameWriter writer(frame, sizeof(frame), FRAME_STATUS, this->pMsgService->nextSeq());
+        this->pContext->serializeFrame(writer);
+        writer.putU8(FIELD_ALIVE, 1);
+        this->pMsgService->sendFrame(frame, writer.finish());
+        return;
+    }
+
+    jsonDoc.clear();
+    this->pContext->serializeData(jsonDoc);
+    jsonDoc[ALIVE] = true;
+    serializeJson(jsonDoc, commonBuf, sizeof(commonBuf));
+
+    this->pMsgService->sendMsgRaw(commonBuf, true);
+}
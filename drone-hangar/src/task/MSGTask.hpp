@@ -4,29 +4,116 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
+#include "devices/LCD.hpp"
+#include "kernel/Journal.hpp"
 #include "kernel/MsgService.hpp"
+#include "kernel/Params.hpp"
 #include "kernel/Task.hpp"
 #include "model/Context.hpp"
+#include "model/History.hpp"
+
+/** @brief Max number of tasks woken when a command is accepted. */
+#define MAX_COMMAND_LISTENERS 2
+
+/** @brief Journal records exported per tick. */
+#define JOURNAL_EXPORT_PER_TICK 4
+
+/** @brief Serial TX room needed before exporting a record. */
+#define JOURNAL_EXPORT_MIN_TX_FREE 24
+
+/** @brief History buckets streamed per tick. */
+#define HISTORY_EXPORT_PER_TICK 4
+
+/** @brief Serial TX room needed before streaming a bucket. */
+#define HISTORY_EXPORT_MIN_TX_FREE 24
+
+/** @brief historyExport value when no window is being streamed. */
+#define HISTORY_IDLE 0xFF
 
 /**
  * @brief Task that continuously consumes messages from serial
  * and stores them in Context's message queue.
  * Also periodically sends JSON state updates to serial.
+ *
+ * Commands and protocol switches are decoded as soon as they are received
+ * (see fastPath()); parameter, history and log level requests are left in
+ * the MsgService queue for tick().
  */
 class MsgTask : public Task
 {
    private:
     Context* pContext;
     MsgServiceClass* pMsgService;
+    LCD* pLcd;
     unsigned long lastJsonSent;
+    Task* commandListeners[MAX_COMMAND_LISTENERS];
+    uint8_t nCommandListeners;
+    uint16_t journalExport;  /**< Next journal record to export, > JOURNAL_CAPACITY when idle */
+    JournalMark journalMark; /**< Ring position when the export started */
+    uint8_t historySignal;   /**< Signal being streamed */
+    HistoryMark historyMark; /**< Resolution being streamed and its position at the start */
+    uint8_t historyExport;   /**< Next bucket to stream, HISTORY_IDLE when idle */
+
+    /**
+     * Decodes a message in the negotiated protocol. With commandsOnly,
+     * anything but a command is left alone and false is returned.
+     */
+    bool handleMsg(const char* content, size_t len, bool commandsOnly);
+
+    /** Parses a JSON line: protocol negotiation or command. */
+    bool handleJson(const char* content, size_t len, bool commandsOnly);
+
+    /** Decodes a COBS frame: command or protocol switch, then acks it. */
+    bool handleFrame(const char* content, size_t len, bool commandsOnly);
+
+    /** Stamps the accepted command and wakes the listeners. */
+    void commandAccepted();
+
+    /** Answers a {"proto":...} request and switches protocol. */
+    void negotiate(const char* proto);
+
+    /** Answers a parameter get/set with its current value. */
+    void sendParam(ParamId id);
+
+    /** Streams a few journal records while the TX buffer has room. */
+    void exportJournal();
+
+    /** Starts streaming a window of the history, false if the query is invalid. */
+    bool startHistory(uint8_t signal, uint8_t level);
+
+    /** Streams a few history buckets while the TX buffer has room. */
+    void exportHistory();
+
+    /** Answers the STATS command with the command store, log and input counters. */
+    void sendStats();
+
+    /** Sends the periodic status in the negotiated protocol. */
+    void sendStatus();
 
    public:
     /**
      * @brief Constructor for MsgTask.
      * @param pContext Pointer to the shared system context.
      * @param pMsgService Pointer to the messaging service.
+     * @param pLcd LCD whose update counters the stats reply carries.
+     */
+    MsgTask(Context* pContext, MsgServiceClass* pMsgService, LCD* pLcd);
+
+    /**
+     * @brief Wake a task at the next slot whenever a command is accepted.
+     * @param task Task consuming commands or reacting to them.
+     * @return true if the task was added, false if there is no room left.
+     */
+    bool addCommandListener(Task* task);
+
+    /**
+     * @brief MsgHandler installed on the MsgService: decodes commands in
+     * the RX path so they reach the Context without waiting for tick().
+     *
+     * It only queues: requests with side effects that can take long, such
+     * as a parameter change, are not consumed and wait for tick().
      */
-    MsgTask(Context* pContext, MsgServiceClass* pMsgService);
+    static bool fastPath(const char* content, size_t len);
 
     /**
      * @brief Task execution method called by the scheduler when the task runs.
@@ -0,0 +1,14 @@
+#include "task/SnapshotTask.hpp"
+
+#include "model/History.hpp"
+#include "model/LedPatterns.hpp"
+
+SnapshotTask::SnapshotTask(Context* pContext) { this->pContext = pContext; }
+
+void SnapshotTask::tick()
+{
+    this->pContext->publish();
+    const ContextSnapshot& snap = this->pContext->getSnapshot();
+    History.sample(millis(), snap);
+    LedPatterns.update(snap);
+}
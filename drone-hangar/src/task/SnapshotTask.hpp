@@ -0,0 +1,35 @@
+#ifndef __SNAPSHOT_TASK__
+#define __SNAPSHOT_TASK__
+
+#include "kernel/Task.hpp"
+#include "model/Context.hpp"
+
+/**
+ * @brief Task that publishes a consistent Context snapshot.
+ *
+ * Registered after the tasks that change the state and before the ones
+ * that only report it (LCD, telemetry), so these see the state of the
+ * current slot as a whole.
+ */
+class SnapshotTask : public Task
+{
+   private:
+    Context* pContext;
+
+   public:
+    /**
+     * @brief Construct a new SnapshotTask object
+     *
+     * @param pContext the system context to publish
+     */
+    SnapshotTask(Context* pContext);
+
+    /**
+     * @brief Task execution method called by the scheduler when the task runs.
+     * Publishes the Context snapshot and feeds it to the History store and
+     * to the LED patterns.
+     */
+    void tick() override;
+};
+
+#endif  // __SNAPSHOT_TASK__
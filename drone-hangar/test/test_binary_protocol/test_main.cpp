@@ -0,0 +1,287 @@
+/*
+ * COBS framing and CRC-16 of kernel/BinaryProtocol, plus a host
+ * benchmark of the status and command messages against the ArduinoJson
+ * path: encode (build and serialize) and decode (parse and read) apart.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include <chrono>
+
+#include <ArduinoJson.h>
+
+#include "config.hpp"
+#include "kernel/BinaryProtocol.hpp"
+#include "kernel/CommandType.hpp"
+
+#define BENCH_FRAMES 200000
+
+void setUp() {}
+
+void tearDown() {}
+
+static size_t buildStatus(uint8_t* frame, uint8_t seq)
+{
+    FrameWriter writer(frame, FRAME_MAX_SIZE, FRAME_STATUS, seq);
+    writer.putU8(FIELD_HANGAR, 2);
+    writer.putU8(FIELD_DRONE, 1);
+    writer.putI16(FIELD_DISTANCE, -123);
+    writer.putU32(FIELD_TIMESTAMP, 0xDEADBEEF);
+    writer.putBytes(FIELD_TEXT, (const uint8_t*)"hello", 5);
+    return writer.finish();
+}
+
+void test_crc16_check_value()
+{
+    // CRC-16/CCITT-FALSE check value of "123456789"
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16((const uint8_t*)"123456789", 9));
+    // Continued over two calls it gives the same result
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16((const uint8_t*)"6789", 4, crc16((const uint8_t*)"12345", 5)));
+}
+
+void test_cobs_round_trip_random_buffers()
+{
+    uint8_t in[600], enc[700], dec[700];
+    srand(1);
+    for (int t = 0; t < 5000; t++)
+    {
+        size_t n = rand() % sizeof(in);
+        for (size_t i = 0; i < n; i++) in[i] = (rand() % 3 == 0) ? 0 : (uint8_t)rand();
+
+        size_t e = cobsEncode(in, n, enc);
+        TEST_ASSERT_LESS_OR_EQUAL(n + n / 254 + 1, e);
+        TEST_ASSERT_NULL(memchr(enc, 0, e));
+        TEST_ASSERT_EQUAL(n, cobsDecode(enc, e, dec));
+        TEST_ASSERT_EQUAL_MEMORY(in, dec, n);
+    }
+}
+
+void test_cobs_long_runs_without_zero()
+{
+    // 254 non-zero bytes fill a block exactly, the next byte opens another
+    static const size_t LENGTHS[] = {253, 254, 255, 508, 509};
+    uint8_t in[600], enc[700], dec[700];
+    for (size_t n : LENGTHS)
+    {
+        memset(in, 0x55, n);
+        size_t e = cobsEncode(in, n, enc);
+        TEST_ASSERT_EQUAL(n + n / 254 + 1, e);
+        TEST_ASSERT_EQUAL(n, cobsDecode(enc, e, dec));
+        TEST_ASSERT_EQUAL_MEMORY(in, dec, n);
+    }
+}
+
+void test_frame_with_zero_bytes_round_trip()
+{
+    uint8_t frame[FRAME_MAX_SIZE], enc[FRAME_MAX_ENCODED], dec[FRAME_MAX_ENCODED];
+    FrameWriter writer(frame, sizeof(frame), FRAME_STATUS, 0);  // seq 0
+    writer.putU8(FIELD_HANGAR, 0);
+    writer.putU32(FIELD_TIMESTAMP, 0x00000100);
+    writer.putI16(FIELD_DISTANCE, 0);
+    size_t n = writer.finish();
+    TEST_ASSERT_NOT_NULL(memchr(frame, 0, n));
+
+    size_t e = cobsEncode(frame, n, enc);
+    TEST_ASSERT_NULL(memchr(enc, 0, e));
+    TEST_ASSERT_EQUAL(n, cobsDecode(enc, e, dec));
+
+    FrameReader reader(dec, n);
+    TEST_ASSERT_TRUE(reader.isValid());
+    TEST_ASSERT_EQUAL_HEX8(FRAME_STATUS, reader.type());
+    TEST_ASSERT_EQUAL(0, reader.seq());
+
+    uint8_t id, len;
+    uint32_t value;
+    const uint8_t* data;
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL_HEX8(FIELD_HANGAR, id);
+    TEST_ASSERT_EQUAL(0, value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL_HEX8(FIELD_TIMESTAMP, id);
+    TEST_ASSERT_EQUAL_HEX32(0x100, value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL_HEX8(FIELD_DISTANCE, id);
+    TEST_ASSERT_EQUAL(0, value);
+    TEST_ASSERT_FALSE(reader.next(id, value, data, len));
+}
+
+void test_fields_round_trip()
+{
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t n = buildStatus(frame, 7);
+    FrameReader reader(frame, n);
+    TEST_ASSERT_TRUE(reader.isValid());
+    TEST_ASSERT_EQUAL(7, reader.seq());
+
+    uint8_t id, len;
+    uint32_t value;
+    const uint8_t* data;
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL(2, value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL(1, value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL(-123, (int16_t)value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, value);
+    TEST_ASSERT_TRUE(reader.next(id, value, data, len));
+    TEST_ASSERT_EQUAL_HEX8(FIELD_TEXT, id);
+    TEST_ASSERT_EQUAL(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("hello", data, 5);
+    TEST_ASSERT_FALSE(reader.next(id, value, data, len));
+}
+
+void test_bad_crc_is_rejected()
+{
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t n = buildStatus(frame, 1);
+    // Any single bit flip, payload or CRC, is caught
+    for (size_t i = 0; i < n; i++)
+    {
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            frame[i] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_FALSE(FrameReader(frame, n).isValid());
+            frame[i] ^= (uint8_t)(1 << bit);
+        }
+    }
+    TEST_ASSERT_TRUE(FrameReader(frame, n).isValid());
+}
+
+void test_truncated_frame_is_rejected()
+{
+    uint8_t frame[FRAME_MAX_SIZE], enc[FRAME_MAX_ENCODED], dec[FRAME_MAX_ENCODED];
+    size_t n = buildStatus(frame, 3);
+
+    // Raw frame cut short: shorter than a header and a CRC, or a bad CRC
+    for (size_t cut = 0; cut < n; cut++) TEST_ASSERT_FALSE(FrameReader(frame, cut).isValid());
+
+    // Encoded frame cut inside a block: the decoder refuses it
+    size_t e = cobsEncode(frame, n, enc);
+    TEST_ASSERT_EQUAL(0, cobsDecode(enc, e - 1, dec));
+    TEST_ASSERT_EQUAL(0, cobsDecode(enc, 0, dec));
+
+    // Cut at a block boundary the bytes decode, the CRC does not match
+    for (size_t cut = 1; cut < e; cut++)
+    {
+        size_t d = cobsDecode(enc, cut, dec);
+        if (d > 0)
+            TEST_ASSERT_FALSE(FrameReader(dec, d).isValid());
+    }
+}
+
+void test_writer_overflow_gives_no_frame()
+{
+    uint8_t frame[8];
+    FrameWriter writer(frame, sizeof(frame), FRAME_STATUS, 0);
+    writer.putU32(FIELD_TIMESTAMP, 1);
+    writer.putU32(FIELD_TIMESTAMP, 2);
+    TEST_ASSERT_EQUAL(0, writer.finish());
+}
+
+/* ns per call of f, over BENCH_FRAMES calls */
+template <typename F>
+static double nsPer(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < BENCH_FRAMES; i++) f(i);
+    std::chrono::duration<double, std::nano> t = std::chrono::steady_clock::now() - start;
+    return t.count() / BENCH_FRAMES;
+}
+
+static void report(const char* message, size_t jsonLen, double jsonEnc, double jsonDec, size_t binLen, double binEnc,
+                   double binDec)
+{
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: json %u B enc %.0f ns dec %.0f ns, binary %u B enc %.0f ns dec %.0f ns", message,
+             (unsigned)jsonLen, jsonEnc, jsonDec, (unsigned)binLen, binEnc, binDec);
+    TEST_MESSAGE(msg);
+}
+
+void test_benchmark_against_json()
+{
+    // The status of Context::serializeData()/serializeFrame() while flying, and an open command
+    StaticJsonDocument<128> doc;
+    char json[128];
+    uint8_t frame[FRAME_MAX_SIZE], enc[FRAME_MAX_ENCODED], dec[FRAME_MAX_ENCODED];
+    size_t jsonLen = 0, encLen = 0;
+    unsigned checked = 0;
+
+    double jsonEnc = nsPer([&](unsigned) {
+        doc.clear();
+        doc[HANGAR_STATE_KEY] = HANGAR_NORMAL_STATE;
+        doc[DRONE_STATE_KEY] = DRONE_OPERATING_STATE;
+        doc[PIR_READY_KEY] = true;
+        doc[DISTANCE_KEY] = 1.234f;
+        doc[ALIVE] = true;
+        jsonLen = serializeJson(doc, json, sizeof(json));
+    });
+    double jsonDec = nsPer([&](unsigned) {
+        deserializeJson(doc, json);
+        const char* drone = doc[DRONE_STATE_KEY];
+        checked += drone != nullptr && doc[DISTANCE_KEY].as<float>() > 1.0f;
+    });
+    double binEnc = nsPer([&](unsigned i) {
+        FrameWriter writer(frame, sizeof(frame), FRAME_STATUS, (uint8_t)i);
+        writer.putU8(FIELD_HANGAR, 0);
+        writer.putU8(FIELD_DRONE, 2);
+        writer.putU8(FIELD_PIR_READY, 1);
+        writer.putI16(FIELD_DISTANCE, 1234);
+        writer.putU8(FIELD_ALIVE, 1);
+        encLen = cobsEncode(frame, writer.finish(), enc);
+    });
+    double binDec = nsPer([&](unsigned) {
+        FrameReader reader(dec, cobsDecode(enc, encLen, dec));
+        uint8_t id, len;
+        uint32_t value;
+        const uint8_t* data;
+        bool valid = reader.isValid();
+        while (valid && reader.next(id, value, data, len)) checked += id == FIELD_DISTANCE && value == 1234;
+    });
+    TEST_ASSERT_EQUAL(2 * BENCH_FRAMES, checked);
+    report("status", jsonLen + 1, jsonEnc, jsonDec, encLen + 1, binEnc, binDec);
+
+    checked = 0;
+    jsonEnc = nsPer([&](unsigned) {
+        doc.clear();
+        doc[COMMAND] = OPEN_CMD;
+        jsonLen = serializeJson(doc, json, sizeof(json));
+    });
+    jsonDec = nsPer([&](unsigned) {
+        deserializeJson(doc, json);
+        const char* cmd = doc[COMMAND];
+        checked += cmd != nullptr && strcmp(cmd, OPEN_CMD) == 0;
+    });
+    binEnc = nsPer([&](unsigned i) {
+        FrameWriter writer(frame, sizeof(frame), FRAME_COMMAND, (uint8_t)i);
+        writer.putU8(FIELD_CMD, (uint8_t)CommandType::OPEN);
+        encLen = cobsEncode(frame, writer.finish(), enc);
+    });
+    binDec = nsPer([&](unsigned) {
+        FrameReader reader(dec, cobsDecode(enc, encLen, dec));
+        uint8_t id, len;
+        uint32_t value;
+        const uint8_t* data;
+        checked += reader.isValid() && reader.next(id, value, data, len) && id == FIELD_CMD &&
+                   value == (uint8_t)CommandType::OPEN;
+    });
+    TEST_ASSERT_EQUAL(2 * BENCH_FRAMES, checked);
+    report("open command", jsonLen + 1, jsonEnc, jsonDec, encLen + 1, binEnc, binDec);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_cobs_round_trip_random_buffers);
+    RUN_TEST(test_cobs_long_runs_without_zero);
+    RUN_TEST(test_frame_with_zero_bytes_round_trip);
+    RUN_TEST(test_fields_round_trip);
+    RUN_TEST(test_bad_crc_is_rejected);
+    RUN_TEST(test_truncated_frame_is_rejected);
+    RUN_TEST(test_writer_overflow_gives_no_frame);
+    RUN_TEST(test_benchmark_against_json);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+/*
+ * Pending commands (model/CommandStore) and their lookup by name
+ * (kernel/PerfectHash), plus a host benchmark of the lookup at 1, 16 and
+ * 64 command names against the linear search it replaced.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unity.h>
+
+#include <chrono>
+
+#include "kernel/PerfectHash.hpp"
+#include "model/CommandStore.hpp"
+#include "model/Context.hpp"
+
+#define BENCH_ROUNDS 200000
+
+#define NAMES_16(X)                                                                              \
+    X("open") X("dump") X("reset") X("stats") X("journal") X("close") X("calibrate") X("status") \
+        X("version") X("reboot") X("mute") X("unmute") X("lights") X("park") X("abort") X("ping")
+
+#define NAMES_48(X)                                                                                        \
+    X("cmd_00") X("cmd_01") X("cmd_02") X("cmd_03") X("cmd_04") X("cmd_05") X("cmd_06") X("cmd_07")        \
+        X("cmd_08") X("cmd_09") X("cmd_10") X("cmd_11") X("cmd_12") X("cmd_13") X("cmd_14") X("cmd_15")    \
+        X("cmd_16") X("cmd_17") X("cmd_18") X("cmd_19") X("cmd_20") X("cmd_21") X("cmd_22") X("cmd_23")    \
+        X("cmd_24") X("cmd_25") X("cmd_26") X("cmd_27") X("cmd_28") X("cmd_29") X("cmd_30") X("cmd_31")    \
+        X("cmd_32") X("cmd_33") X("cmd_34") X("cmd_35") X("cmd_36") X("cmd_37") X("cmd_38") X("cmd_39")    \
+        X("cmd_40") X("cmd_41") X("cmd_42") X("cmd_43") X("cmd_44") X("cmd_45") X("cmd_46") X("cmd_47")
+
+#define NAME(name) name,
+
+static constexpr const char* NAMES_1[] = {"open"};
+static constexpr const char* NAMES_16[] = {NAMES_16(NAME)};
+static constexpr const char* NAMES_64[] = {NAMES_16(NAME) NAMES_48(NAME)};
+
+static constexpr PerfectHashTable<1> HASH_1 = makePerfectHash(NAMES_1);
+static constexpr PerfectHashTable<16> HASH_16 = makePerfectHash(NAMES_16);
+static constexpr PerfectHashTable<64> HASH_64 = makePerfectHash(NAMES_64);
+static_assert(HASH_1.ok && HASH_16.ok && HASH_64.ok, "benchmark names collide");
+
+void setUp() {}
+
+void tearDown() {}
+
+/* Context::tryEnqueueMsg() without PROGMEM */
+template <size_t N>
+static int hashLookup(const PerfectHashTable<N>& table, const char* const (&names)[N], const char* name)
+{
+    uint8_t k = table.key[perfectHash(name, table.disp[perfectHash(name, 0) % N]) % N];
+    return strcasecmp(name, names[k]) == 0 ? k : -1;
+}
+
+/* The table search it replaced */
+template <size_t N>
+static int linearLookup(const char* const (&names)[N], const char* name)
+{
+    for (size_t k = 0; k < N; k++)
+    {
+        if (strcasecmp(name, names[k]) == 0)
+            return (int)k;
+    }
+    return -1;
+}
+
+void test_push_pop_overflow_and_expiry()
+{
+    CommandStore store;
+    TEST_ASSERT_TRUE(store.push(CommandType::OPEN, 0));
+    TEST_ASSERT_TRUE(store.push(CommandType::OPEN, 10));
+    TEST_ASSERT_FALSE(store.push(CommandType::OPEN, 20));  // CMD_MAX_PER_TYPE
+    TEST_ASSERT_EQUAL(1, store.getOverflows());
+    TEST_ASSERT_TRUE(store.push(CommandType::DUMP_LOG, 4000));
+
+    store.expire(CONFIG_CMD_TTL_MS);
+    TEST_ASSERT_EQUAL(1, store.getExpired());
+    TEST_ASSERT_TRUE(store.isPending(CommandType::OPEN));
+    TEST_ASSERT_TRUE(store.pop(CommandType::OPEN, CONFIG_CMD_TTL_MS + 5));
+    TEST_ASSERT_FALSE(store.isPending(CommandType::OPEN));
+
+    TEST_ASSERT_FALSE(store.pop(CommandType::DUMP_LOG, 4000 + CONFIG_CMD_TTL_MS));
+    TEST_ASSERT_EQUAL(2, store.getExpired());
+    TEST_ASSERT_EQUAL(0, store.getPendingMask());
+}
+
+void test_deadline_across_the_millis_wrap()
+{
+    CommandStore store;
+    uint32_t near = 0xFFFFFF00UL;
+    TEST_ASSERT_TRUE(store.push(CommandType::OPEN, near));
+    TEST_ASSERT_TRUE(store.pop(CommandType::OPEN, near + CONFIG_CMD_TTL_MS - 1));
+    TEST_ASSERT_TRUE(store.push(CommandType::OPEN, near));
+    store.expire(near + CONFIG_CMD_TTL_MS);
+    TEST_ASSERT_EQUAL(0, store.getPendingMask());
+}
+
+void test_pool_entries_are_recycled()
+{
+    CommandStore store;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_TRUE(store.push(CommandType::OPEN, i));
+        TEST_ASSERT_TRUE(store.pop(CommandType::OPEN, i));
+    }
+    TEST_ASSERT_EQUAL(0, store.getOverflows());
+}
+
+void test_reset_is_refused_outside_alarm()
+{
+    Context context;
+    TEST_ASSERT_FALSE(context.tryEnqueueMsg("reset"));
+    TEST_ASSERT_FALSE(context.tryEnqueueCommand((uint8_t)CommandType::RESET_ALARM));
+
+    // A later alarm is not cleared by the early reset
+    context.setAlarm(true);
+    TEST_ASSERT_FALSE(context.consumeCommand(CommandType::RESET_ALARM));
+    TEST_ASSERT_TRUE(context.tryEnqueueMsg("RESET"));
+    TEST_ASSERT_TRUE(context.consumeCommand(CommandType::RESET_ALARM));
+    TEST_ASSERT_TRUE(context.tryEnqueueMsg(" open"));
+    TEST_ASSERT_FALSE(context.tryEnqueueMsg("opened"));
+}
+
+void test_every_name_is_found()
+{
+    for (size_t k = 0; k < 64; k++) TEST_ASSERT_EQUAL(k, hashLookup(HASH_64, NAMES_64, NAMES_64[k]));
+    TEST_ASSERT_EQUAL(-1, hashLookup(HASH_64, NAMES_64, "cmd_64"));
+    TEST_ASSERT_EQUAL(-1, hashLookup(HASH_16, NAMES_16, ""));
+    TEST_ASSERT_EQUAL(0, hashLookup(HASH_1, NAMES_1, "OPEN"));
+}
+
+template <size_t N>
+static void benchmark(const PerfectHashTable<N>& table, const char* const (&names)[N])
+{
+    // Every name once, then as many misses
+    volatile int sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < BENCH_ROUNDS / N; r++)
+    {
+        for (size_t k = 0; k < N; k++) sink = sink + hashLookup(table, names, names[k]);
+        for (size_t k = 0; k < N; k++) sink = sink + hashLookup(table, names, "nope");
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < BENCH_ROUNDS / N; r++)
+    {
+        for (size_t k = 0; k < N; k++) sink = sink + linearLookup(names, names[k]);
+        for (size_t k = 0; k < N; k++) sink = sink + linearLookup(names, "nope");
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double lookups = 2.0 * N * (BENCH_ROUNDS / N);
+    std::chrono::duration<double, std::nano> hash = t1 - t0, linear = t2 - t1;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%2u names: perfect hash %.0f ns, linear %.0f ns per lookup", (unsigned)N,
+             hash.count() / lookups, linear.count() / lookups);
+    TEST_MESSAGE(msg);
+}
+
+void test_benchmark_lookup()
+{
+    benchmark(HASH_1, NAMES_1);
+    benchmark(HASH_16, NAMES_16);
+    benchmark(HASH_64, NAMES_64);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_push_pop_overflow_and_expiry);
+    RUN_TEST(test_deadline_across_the_millis_wrap);
+    RUN_TEST(test_pool_entries_are_recycled);
+    RUN_TEST(test_reset_is_refused_outside_alarm);
+    RUN_TEST(test_every_name_is_found);
+    RUN_TEST(test_benchmark_lookup);
+    return UNITY_END();
+}
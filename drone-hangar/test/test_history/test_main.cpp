@@ -0,0 +1,93 @@
+/*
+ * Multi-resolution history (model/History): folding into the coarser
+ * levels, distance samples without an echo, and reads against a mark
+ * while buckets keep closing.
+ */
+#include <unity.h>
+
+#include "model/History.hpp"
+
+static ContextSnapshot snap;
+
+void setUp() {}
+
+void tearDown() {}
+
+/* One sample every 100 ms from start, as SnapshotTask would give */
+static unsigned long feed(HistoryStore& history, unsigned long start, unsigned long ms, float distance)
+{
+    snap.distance = distance;
+    for (unsigned long t = start; t < start + ms; t += 100) history.sample(t, snap);
+    return start + ms;
+}
+
+void test_gaps_do_not_count_as_zero()
+{
+    HistoryStore history;
+    snap.temperature = 22.0f;
+    unsigned long t = feed(history, 0, 1000, 1.0f);
+    t = feed(history, t, 500, -1.0f);
+    t = feed(history, t, 500, 2.0f);
+    t = feed(history, t, 1000, -1.0f);
+    feed(history, t, 100, -1.0f);  // closes the last bucket
+
+    int16_t min, max, avg;
+    HistoryMark at = history.mark(HIST_1S);
+    TEST_ASSERT_EQUAL(3, at.count);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 0, min, max, avg));
+    TEST_ASSERT_EQUAL(-1, min);
+    TEST_ASSERT_EQUAL(-1, avg);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 1, min, max, avg));
+    TEST_ASSERT_EQUAL(2000, min);
+    TEST_ASSERT_EQUAL(2000, avg);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 2, min, max, avg));
+    TEST_ASSERT_EQUAL(1000, max);
+    TEST_ASSERT_TRUE(history.read(HIST_TEMPERATURE, at, 0, min, max, avg));
+    TEST_ASSERT_EQUAL(220, avg);
+}
+
+void test_coarser_levels_fold_the_finer_buckets()
+{
+    HistoryStore history;
+    unsigned long t = 0;
+    for (int s = 0; s < 10; s++) t = feed(history, t, 1000, s < 5 ? 0.4f : -1.0f);
+    feed(history, t, 100, -1.0f);
+
+    int16_t min, max, avg;
+    HistoryMark at = history.mark(HIST_10S);
+    TEST_ASSERT_EQUAL(1, at.count);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 0, min, max, avg));
+    TEST_ASSERT_EQUAL(400, min);
+    TEST_ASSERT_EQUAL(400, avg);  // the five seconds without echo are left out
+}
+
+void test_mark_keeps_the_indexes_while_buckets_close()
+{
+    HistoryStore history;
+    unsigned long t = 0;
+    for (int s = 0; s < HISTORY_LEN_1S; s++) t = feed(history, t, 1000, 0.02f * (s + 1));
+    feed(history, t, 100, 1.0f);
+
+    HistoryMark at = history.mark(HIST_1S);
+    int16_t min, max, avg;
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 0, min, max, avg));
+    TEST_ASSERT_EQUAL(20 * HISTORY_LEN_1S, avg);
+
+    // Three more buckets: the newest at the mark is still index 0, the three oldest are gone
+    t = feed(history, t, 3000, 1.0f);
+    feed(history, t, 100, 1.0f);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, 0, min, max, avg));
+    TEST_ASSERT_EQUAL(20 * HISTORY_LEN_1S, avg);
+    TEST_ASSERT_TRUE(history.read(HIST_DISTANCE, at, HISTORY_LEN_1S - 4, min, max, avg));
+    TEST_ASSERT_EQUAL(80, avg);
+    TEST_ASSERT_FALSE(history.read(HIST_DISTANCE, at, HISTORY_LEN_1S - 3, min, max, avg));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_gaps_do_not_count_as_zero);
+    RUN_TEST(test_coarser_levels_fold_the_finer_buckets);
+    RUN_TEST(test_mark_keeps_the_indexes_while_buckets_close);
+    return UNITY_END();
+}
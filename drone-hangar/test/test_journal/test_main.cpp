@@ -0,0 +1,191 @@
+/*
+ * EEPROM journal (kernel/Journal) on the simulated EEPROM: background
+ * format of a blank region, exports against a mark, and one million
+ * records over 50 reboots for the wear leveling. The tests share the
+ * EEPROM and run in order.
+ */
+#include <unity.h>
+
+#include "kernel/Journal.hpp"
+#include "sim/SimArduino.hpp"
+#include "sim/SimClock.hpp"
+
+#define WEAR_BOOTS 50
+#define WEAR_RECORDS_PER_BOOT 20000
+
+#define FIRST_CELL (JOURNAL_EEPROM_ADDR + 2)
+#define LAST_CELL (FIRST_CELL + JOURNAL_CAPACITY * JOURNAL_RECORD_SIZE)
+
+void setUp() {}
+
+void tearDown() {}
+
+/* The background step, with the EEPROM given the time to finish every write */
+static void flushFor(JournalService& journal, unsigned steps)
+{
+    for (unsigned i = 0; i < steps; i++)
+    {
+        journal.flush();
+        SimClock.advance(SIM_EEPROM_WRITE_US);
+    }
+}
+
+/* Index of the newest record seen from a fresh mark, -1 if none */
+static int newest(const JournalService& journal)
+{
+    JournalMark at = journal.mark();
+    uint16_t delta;
+    uint8_t subsystem, states;
+    int last = -1;
+    for (uint16_t i = 0; i < journal.size(); i++)
+    {
+        if (journal.read(at, i, delta, subsystem, states))
+            last = i;
+    }
+    return last;
+}
+
+void test_first_boot_formats_in_the_background()
+{
+    JournalService journal;
+    uint64_t start = SimClock.nowUs();
+    journal.init();
+    TEST_ASSERT_LESS_THAN(start + SIM_EEPROM_WRITE_US, SimClock.nowUs());  // nothing written yet
+    TEST_ASSERT_EQUAL(-1, newest(journal));
+
+    // Two bytes per slot and the header, then the BOOT record
+    flushFor(journal, 2 * JOURNAL_CAPACITY + 2 + JOURNAL_RECORD_SIZE);
+    TEST_ASSERT_EQUAL(JOURNAL_CAPACITY - 1, newest(journal));
+
+    JournalService next;
+    next.init();
+    flushFor(next, JOURNAL_RECORD_SIZE);
+    JournalMark at = next.mark();
+    uint16_t delta;
+    uint8_t subsystem, states;
+    TEST_ASSERT_TRUE(next.read(at, JOURNAL_CAPACITY - 2, delta, subsystem, states));
+    TEST_ASSERT_EQUAL(JOURNAL_BOOT, subsystem);
+    TEST_ASSERT_TRUE(next.read(at, JOURNAL_CAPACITY - 1, delta, subsystem, states));
+    TEST_ASSERT_EQUAL(JOURNAL_BOOT, subsystem);
+}
+
+void test_export_ignores_records_written_after_the_mark()
+{
+    JournalService journal;
+    journal.init();
+    for (uint8_t k = 0; k < 5; k++)
+    {
+        journal.record(JOURNAL_DRONE, k, k + 1);
+        flushFor(journal, JOURNAL_RECORD_SIZE);
+    }
+    flushFor(journal, JOURNAL_RECORD_SIZE);
+
+    JournalMark at = journal.mark();
+    for (uint8_t k = 0; k < 10; k++)
+    {
+        journal.record(JOURNAL_DOOR, 0, 1);
+        flushFor(journal, JOURNAL_RECORD_SIZE);
+    }
+    journal.record(JOURNAL_DOOR, 1, 2);
+    flushFor(journal, 2);  // cut inside the record
+
+    uint16_t delta;
+    uint8_t subsystem, states;
+    uint16_t read = 0, drone = 0;
+    for (uint16_t i = 0; i < journal.size(); i++)
+    {
+        if (!journal.read(at, i, delta, subsystem, states))
+            continue;
+        read++;
+        TEST_ASSERT_NOT_EQUAL(JOURNAL_DOOR, subsystem);
+        if (subsystem == JOURNAL_DRONE)
+        {
+            TEST_ASSERT_EQUAL((drone << 4) | (drone + 1), states);
+            drone++;
+        }
+    }
+    TEST_ASSERT_EQUAL(5, drone);
+    TEST_ASSERT_EQUAL(3 + 5, read);  // a BOOT per test so far and the DRONE records
+}
+
+void test_million_records_level_the_wear()
+{
+    static uint32_t before[LAST_CELL];
+    for (int a = FIRST_CELL; a < LAST_CELL; a++) before[a] = simEepromWrites(a);
+
+    for (int boot = 0; boot < WEAR_BOOTS; boot++)
+    {
+        JournalService journal;
+        journal.init();
+        for (int k = 0; k < WEAR_RECORDS_PER_BOOT; k++)
+        {
+            journal.record(JOURNAL_DRONE, k & 3, (k + 1) & 3);
+            flushFor(journal, JOURNAL_RECORD_SIZE);
+        }
+        flushFor(journal, JOURNAL_RECORD_SIZE);
+
+        // The head is found again after every reboot: the newest record is the last one
+        TEST_ASSERT_EQUAL(JOURNAL_CAPACITY - 1, newest(journal));
+        uint16_t delta;
+        uint8_t subsystem, states;
+        TEST_ASSERT_TRUE(journal.read(journal.mark(), JOURNAL_CAPACITY - 1, delta, subsystem, states));
+        TEST_ASSERT_EQUAL(JOURNAL_DRONE, subsystem);
+        TEST_ASSERT_EQUAL(WEAR_RECORDS_PER_BOOT & 3, states & 0x0F);
+    }
+
+    // Every sequence byte is rewritten once per lap of the ring
+    uint32_t records = WEAR_BOOTS * (WEAR_RECORDS_PER_BOOT + 1);
+    uint32_t minWrites = 0xFFFFFFFF, maxWrites = 0;
+    for (int a = FIRST_CELL; a < LAST_CELL; a++)
+    {
+        uint32_t w = simEepromWrites(a) - before[a];
+        minWrites = w < minWrites ? w : minWrites;
+        maxWrites = w > maxWrites ? w : maxWrites;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(records / JOURNAL_CAPACITY + 1, maxWrites);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%lu records on %u slots: %lu to %lu writes per cell", (unsigned long)records,
+             (unsigned)JOURNAL_CAPACITY, (unsigned long)minWrites, (unsigned long)maxWrites);
+    TEST_MESSAGE(msg);
+}
+
+void test_export_of_a_full_ring_skips_the_rewritten_slots()
+{
+    JournalService journal;
+    journal.init();
+    flushFor(journal, JOURNAL_RECORD_SIZE);
+
+    JournalMark at = journal.mark();
+    for (uint8_t k = 0; k < 10; k++)
+    {
+        journal.record(JOURNAL_DOOR, 0, 1);
+        flushFor(journal, JOURNAL_RECORD_SIZE);
+    }
+    journal.record(JOURNAL_DOOR, 1, 2);
+    flushFor(journal, 2);
+
+    uint16_t delta;
+    uint8_t subsystem, states;
+    uint16_t read = 0;
+    for (uint16_t i = 0; i < journal.size(); i++)
+    {
+        if (!journal.read(at, i, delta, subsystem, states))
+            continue;
+        read++;
+        TEST_ASSERT_NOT_EQUAL(JOURNAL_DOOR, subsystem);
+    }
+    TEST_ASSERT_EQUAL(JOURNAL_CAPACITY - 11, read);  // the oldest 11 were rewritten
+    TEST_ASSERT_TRUE(journal.read(at, JOURNAL_CAPACITY - 1, delta, subsystem, states));
+    TEST_ASSERT_EQUAL(JOURNAL_BOOT, subsystem);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_formats_in_the_background);
+    RUN_TEST(test_export_ignores_records_written_after_the_mark);
+    RUN_TEST(test_million_records_level_the_wear);
+    RUN_TEST(test_export_of_a_full_ring_skips_the_rewritten_slots);
+    return UNITY_END();
+}
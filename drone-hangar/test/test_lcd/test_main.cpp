@@ -0,0 +1,150 @@
+/*
+ * Shadow framebuffer of devices/LCD on the simulated HD44780: the bytes
+ * of the state transitions against a clear and a full rewrite, flushes
+ * spread over a budget or given none, coalescing, and a dashboard field
+ * step.
+ */
+#include <LiquidCrystal_I2C.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "config.hpp"
+#include "devices/LCD.hpp"
+
+void setUp() {}
+
+void tearDown() {}
+
+/* The glass row, compared with text padded with spaces */
+static void assertRow(const char* text, uint8_t row)
+{
+    char expected[LCD_COL];
+    size_t n = strlen(text);
+    memset(expected, ' ', sizeof(expected));
+    memcpy(expected, text, n < LCD_COL ? n : LCD_COL);
+    TEST_ASSERT_EQUAL_MEMORY(expected, LiquidCrystal_I2C::instance->line(row), LCD_COL);
+}
+
+/* HD44780 bytes sent by one call */
+template <typename F>
+static unsigned long writesOf(F call)
+{
+    unsigned long before = LiquidCrystal_I2C::instance->getWrites();
+    call();
+    return LiquidCrystal_I2C::instance->getWrites() - before;
+}
+
+void test_state_transitions_write_the_changed_cells()
+{
+    static const char* STATES[] = {LCD_REST_STATE,      LCD_TAKING_OFF_STATE, LCD_ALARM_STATE, LCD_REST_STATE,
+                                   LCD_OPERATING_STATE, LCD_LANDING_STATE};
+    // Measured once, a change shows up here and in the table of the report
+    static const unsigned long EXPECTED[] = {9, 6, 13, 7, 10};
+
+    LCD lcd(LCD_ADR, LCD_COL, LCD_ROW);
+    lcd.print(STATES[0]);
+    for (size_t i = 1; i < sizeof(STATES) / sizeof(STATES[0]); i++)
+    {
+        unsigned long writes = writesOf([&] { lcd.print(STATES[i]); });
+        assertRow(STATES[i], 0);
+        TEST_ASSERT_EQUAL(EXPECTED[i - 1], writes);
+        TEST_ASSERT_EQUAL(writes * LCD_I2C_BYTES_PER_WRITE, lcd.getLastI2CBytes());
+
+        char msg[80];
+        unsigned long before = 2 + strlen(STATES[i]);  // clear, cursor, every character
+        snprintf(msg, sizeof(msg), "%s -> %s: %lu bytes, %lu before", STATES[i - 1], STATES[i], writes, before);
+        TEST_MESSAGE(msg);
+    }
+}
+
+void test_flush_spreads_a_full_screen_over_the_budget()
+{
+    LCD lcd(LCD_ADR, LCD_COL, LCD_ROW);
+    lcd.show("HANGAR DOOR OPENING PLEASE");
+    uint8_t pending = lcd.getPendingWrites();
+    TEST_ASSERT_GREATER_THAN(6, pending);
+
+    // Every flush makes progress within its budget, and the split costs no extra byte
+    unsigned long total = 0;
+    bool done = false;
+    for (unsigned flushes = 0; !done && flushes < pending; flushes++)
+    {
+        unsigned long writes = writesOf([&] { done = lcd.flush(LCD_FLUSH_MAX_US); });
+        TEST_ASSERT_GREATER_THAN(0, writes);
+        TEST_ASSERT_LESS_OR_EQUAL(LCD_FLUSH_MAX_US / LCD_WRITE_US, writes);
+        total += writes;
+    }
+    TEST_ASSERT_TRUE(done);
+    TEST_ASSERT_EQUAL(pending, total);
+    TEST_ASSERT_EQUAL(0, lcd.getPendingWrites());
+    assertRow("HANGAR DOOR OPENING", 0);
+    assertRow("PLEASE", 1);
+}
+
+void test_flush_without_budget_still_ends()
+{
+    LCD lcd(LCD_ADR, LCD_COL, LCD_ROW);
+    lcd.print("HANGAR DOOR OPENING PLEASE");
+    lcd.show("ALARM");  // cheaper with a clear, which never fits
+    uint8_t pending = lcd.getPendingWrites();
+
+    bool done = false;
+    for (unsigned flushes = 0; !done && flushes < pending; flushes++)
+    {
+        unsigned long writes = writesOf([&] { done = lcd.flush(0); });
+        TEST_ASSERT_GREATER_THAN(0, writes);
+        TEST_ASSERT_LESS_OR_EQUAL(LCD_MIN_FLUSH_WRITES, writes);
+    }
+    TEST_ASSERT_TRUE(done);
+    assertRow("ALARM", 0);
+    assertRow("", 1);
+}
+
+void test_new_content_replaces_the_pending_one()
+{
+    LCD lcd(LCD_ADR, LCD_COL, LCD_ROW);
+    lcd.show(LCD_TAKING_OFF_STATE, 1);
+    lcd.put(1, 0, "T:24.6C", 8);  // same frame, nothing replaced yet
+    TEST_ASSERT_EQUAL(0, lcd.getCoalesced());
+    TEST_ASSERT_FALSE(lcd.flush(3 * LCD_WRITE_US));
+
+    // A frame of a message and two fields counts once
+    lcd.show(LCD_ALARM_STATE, 1);
+    lcd.put(1, 0, "T:24.8C", 8);
+    lcd.put(1, 10, "D:0.18m", 10);
+    TEST_ASSERT_EQUAL(1, lcd.getCoalesced());
+    TEST_ASSERT_TRUE(lcd.flush(LCD_FLUSH_UNLIMITED));
+    assertRow(LCD_ALARM_STATE, 0);
+    assertRow("T:24.8C   D:0.18m", 1);
+}
+
+void test_dashboard_field_step()
+{
+    LCD lcd(LCD_ADR, LCD_COL, LCD_ROW);
+    lcd.show(LCD_REST_STATE, 1);
+    lcd.put(1, 10, "D:0.18m", 10);
+    lcd.flush(LCD_FLUSH_UNLIMITED);
+    assertRow("          D:0.18m", 1);
+
+    // A 2 cm step rewrites two digits after a cursor move
+    lcd.put(1, 10, "D:0.20m", 10);
+    TEST_ASSERT_EQUAL(3, writesOf([&] { lcd.flush(LCD_FLUSH_UNLIMITED); }));
+    assertRow("          D:0.20m", 1);
+    assertRow(LCD_REST_STATE, 0);
+
+    // The same value again costs nothing
+    lcd.put(1, 10, "D:0.20m", 10);
+    TEST_ASSERT_EQUAL(0, lcd.getPendingWrites());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_state_transitions_write_the_changed_cells);
+    RUN_TEST(test_flush_spreads_a_full_screen_over_the_budget);
+    RUN_TEST(test_flush_without_budget_still_ends);
+    RUN_TEST(test_new_content_replaces_the_pending_one);
+    RUN_TEST(test_dashboard_field_step);
+    return UNITY_END();
+}
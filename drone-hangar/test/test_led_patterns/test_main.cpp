@@ -0,0 +1,155 @@
+/*
+ * LED pattern engine (model/LedPatterns) with its interrupt called in a
+ * loop: blink and double-blink edges, the fade on the PWM pin and its
+ * fallback elsewhere, a blink_period change, and a pattern shown by the
+ * hardware test until the next snapshot. The levels are read back
+ * from the port and PWM registers the interrupt writes.
+ */
+#include <unity.h>
+
+#include "config.hpp"
+#include "kernel/Params.hpp"
+#include "model/LedPatterns.hpp"
+#include "sim/SimDevices.hpp"
+
+/* Timer0 compare A ticks of a duration, as the engine rounds them */
+#define TICKS(ms) ((uint32_t)(ms) * 125 / 128)
+
+void setUp() { Params.set(PARAM_BLINK_PERIOD, L2_BLINK_PERIOD); }
+
+void tearDown() {}
+
+/* Ticks until the level of the light changes, at most limit */
+static uint32_t ticksToEdge(LedPatternEngine& engine, const SimLight& light, uint32_t limit)
+{
+    uint8_t level = light.level();
+    for (uint32_t t = 1; t <= limit; t++)
+    {
+        engine.tick();
+        if (light.level() != level)
+            return t;
+    }
+    return 0;
+}
+
+void test_blink_follows_blink_period()
+{
+    LedPatternEngine engine;
+    SimLight l2(L2_PIN);
+    ContextSnapshot snap = {};
+    snap.pirReady = 1;
+    snap.blinking = 1;
+    engine.attach(LED_L2, L2_PIN);
+    engine.update(snap);
+
+    TEST_ASSERT_EQUAL(255, l2.level());
+    TEST_ASSERT_EQUAL(TICKS(L2_BLINK_PERIOD), ticksToEdge(engine, l2, 2000));
+    TEST_ASSERT_EQUAL(0, l2.level());
+    TEST_ASSERT_EQUAL(TICKS(L2_BLINK_PERIOD), ticksToEdge(engine, l2, 2000));
+
+    // 10 ticks into a segment: it keeps its length, the next one takes the new period
+    TEST_ASSERT_EQUAL(0, ticksToEdge(engine, l2, 10));
+    Params.set(PARAM_BLINK_PERIOD, 200);
+    engine.update(snap);
+    TEST_ASSERT_EQUAL(TICKS(L2_BLINK_PERIOD) - 10, ticksToEdge(engine, l2, 2000));
+    TEST_ASSERT_EQUAL(TICKS(200), ticksToEdge(engine, l2, 2000));
+
+    snap.blinking = 0;
+    engine.update(snap);
+    TEST_ASSERT_EQUAL(0, l2.level());
+    TEST_ASSERT_EQUAL(0, ticksToEdge(engine, l2, 2000));
+}
+
+void test_double_blink_in_pre_alarm()
+{
+    LedPatternEngine engine;
+    SimLight l3(L3_PIN);
+    ContextSnapshot snap = {};
+    snap.preAlarmActive = 1;
+    engine.attach(LED_L3, L3_PIN);
+    engine.update(snap);
+
+    // 100 ms on, 150 ms off, twice, then dark for the rest of the second
+    for (int round = 0; round < 2; round++)
+    {
+        TEST_ASSERT_EQUAL(255, l3.level());
+        TEST_ASSERT_EQUAL(TICKS(100), ticksToEdge(engine, l3, 2000));
+        TEST_ASSERT_EQUAL(TICKS(150), ticksToEdge(engine, l3, 2000));
+        TEST_ASSERT_EQUAL(TICKS(100), ticksToEdge(engine, l3, 2000));
+        TEST_ASSERT_EQUAL(TICKS(1000) - 2 * TICKS(100) - TICKS(150), ticksToEdge(engine, l3, 2000));
+    }
+
+    snap.alarmActive = 1;
+    engine.update(snap);
+    TEST_ASSERT_EQUAL(255, l3.level());
+    TEST_ASSERT_EQUAL(0, ticksToEdge(engine, l3, 2000));
+}
+
+void test_fade_needs_the_pwm_pin()
+{
+    LedPatternEngine engine;
+    SimLight l1(L1_PIN), l2(L2_PIN);
+    ContextSnapshot snap = {};
+    engine.attach(LED_L1, L1_PIN);
+    engine.attach(LED_L2, L2_PIN);
+    engine.update(snap);  // PIR warming up: L2 breathes
+
+    // Up the gamma table in half the period, then back down
+    uint32_t step = TICKS(2000) / (2 * (LED_GAMMA_STEPS - 1));
+    uint32_t t = 0;
+    uint8_t previous = l2.level();
+    while (l2.level() != 255 && t < TICKS(2000))
+    {
+        engine.tick();
+        t++;
+        TEST_ASSERT_GREATER_OR_EQUAL(previous, l2.level());
+        previous = l2.level();
+    }
+    TEST_ASSERT_EQUAL((LED_GAMMA_STEPS - 1) * step, t);
+    TEST_ASSERT_EQUAL(255, l1.level());  // SOLID
+
+    // The same pattern on a pin without PWM is simply lit
+    LedPatternEngine plain;
+    SimLight l3(L3_PIN);
+    plain.attach(LED_L2, L3_PIN);
+    plain.update(snap);
+    TEST_ASSERT_EQUAL(255, l3.level());
+    TEST_ASSERT_EQUAL(0, ticksToEdge(plain, l3, 2000));
+
+    snap.pirReady = 1;
+    engine.update(snap);
+    TEST_ASSERT_EQUAL(0, l2.level());
+    TEST_ASSERT_EQUAL(0, TCCR0A & _BV(COM0B1));  // the port drives the pin again
+}
+
+void test_show_holds_until_the_next_update()
+{
+    LedPatternEngine engine;
+    SimLight l1(L1_PIN), l3(L3_PIN);
+    ContextSnapshot snap = {};
+    engine.attach(LED_L1, L1_PIN);
+    engine.attach(LED_L3, L3_PIN);
+
+    engine.show(LED_L3, LED_SOLID);
+    TEST_ASSERT_EQUAL(255, l3.level());
+    TEST_ASSERT_EQUAL(0, l1.level());  // not attached to a pattern yet
+    TEST_ASSERT_EQUAL(0, ticksToEdge(engine, l3, 2000));
+
+    engine.show(LED_L3, LED_DOUBLE_BLINK);
+    TEST_ASSERT_EQUAL(TICKS(100), ticksToEdge(engine, l3, 2000));
+
+    // A snapshot takes the LEDs back
+    engine.update(snap);
+    TEST_ASSERT_EQUAL(0, l3.level());
+    TEST_ASSERT_EQUAL(255, l1.level());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_blink_follows_blink_period);
+    RUN_TEST(test_double_blink_in_pre_alarm);
+    RUN_TEST(test_fade_needs_the_pwm_pin);
+    RUN_TEST(test_show_holds_until_the_next_update);
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+/*
+ * Rate limiting of kernel/Logger: repeats keyed on the message and its
+ * argument, the SUPPRESSED report, the acks that are never limited and
+ * the least recently used table of the last emissions.
+ */
+#include <Arduino.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include <string>
+
+#include "kernel/Logger.hpp"
+#include "sim/SimClock.hpp"
+#include "sim/SimSerial.hpp"
+
+static std::string output;
+
+static void keepOutput(uint8_t c) { output += (char)c; }
+
+/* Lines holding text since the last clear */
+static unsigned linesWith(const char* text)
+{
+    unsigned n = 0;
+    for (size_t at = output.find(text); at != std::string::npos; at = output.find(text, at + 1)) n++;
+    return n;
+}
+
+/* Repeats reported by the SUPPRESSED lines since the last clear */
+static unsigned suppressedCount()
+{
+    static const char TAG[] = "SUPPRESSED ";
+    unsigned n = 0;
+    for (size_t at = output.find(TAG); at != std::string::npos; at = output.find(TAG, at + 1))
+        n += atoi(output.c_str() + at + sizeof(TAG) - 1);
+    return n;
+}
+
+/* Let ms pass while the logger drains, as the scheduler's background step would */
+static void drainFor(unsigned long ms)
+{
+    for (unsigned long t = 0; t < ms; t += 10)
+    {
+        Logger.drain();
+        SimClock.advance(10000);
+    }
+}
+
+void setUp()
+{
+    drainFor(3 * LOG_RATE_WINDOW_MS);  // every earlier emission out of the window
+    output.clear();
+}
+
+void tearDown() {}
+
+void test_same_message_and_argument_is_limited()
+{
+    for (int i = 0; i < 10; i++)
+    {
+        Logger.log(LOG_HT_PREALARM, 41);
+        drainFor(100);
+    }
+    TEST_ASSERT_EQUAL(1, linesWith("PREALARM ACTIVE 41\r"));
+
+    // Another argument is another message
+    Logger.log(LOG_HT_PREALARM, 42);
+    drainFor(LOG_RATE_WINDOW_MS);
+    TEST_ASSERT_EQUAL(1, linesWith("PREALARM ACTIVE 42\r"));
+    TEST_ASSERT_EQUAL(9, suppressedCount());
+    TEST_ASSERT_LESS_OR_EQUAL(2, linesWith("SUPPRESSED"));  // at most once per window
+
+    // Out of the window it goes out again
+    Logger.log(LOG_HT_PREALARM, 41);
+    drainFor(100);
+    TEST_ASSERT_EQUAL(2, linesWith("PREALARM ACTIVE 41\r"));
+}
+
+void test_acks_are_never_limited()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        Logger.log(LOG_CMD_OK);
+        Logger.log(LOG_CMD_ERR);
+        drainFor(100);
+    }
+    TEST_ASSERT_EQUAL(5, linesWith("CMD_OK\r"));
+    TEST_ASSERT_EQUAL(5, linesWith("CMD_ERR\r"));
+    drainFor(LOG_RATE_WINDOW_MS);
+    TEST_ASSERT_EQUAL(0, suppressedCount());
+}
+
+void test_least_recently_used_entry_is_forgotten()
+{
+    // A repeat keeps its entry recent: 40 survives four other arguments
+    for (int16_t arg = 40; arg < 40 + LOG_RATE_SLOTS; arg++) Logger.log(LOG_HT_PREALARM, arg);
+    Logger.log(LOG_HT_PREALARM, 40);
+    Logger.log(LOG_HT_PREALARM, 40 + LOG_RATE_SLOTS);
+    Logger.log(LOG_HT_PREALARM, 40);
+    drainFor(100);
+    TEST_ASSERT_EQUAL(1, linesWith("PREALARM ACTIVE 40\r"));
+
+    // 41 was the least recently used one and is sent again
+    Logger.log(LOG_HT_PREALARM, 41);
+    drainFor(100);
+    TEST_ASSERT_EQUAL(2, linesWith("PREALARM ACTIVE 41\r"));
+}
+
+int main()
+{
+    SimSerial.setSink(keepOutput);
+    SimClock.addSource(&SimSerial);
+    Serial.begin(115200);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_same_message_and_argument_is_limited);
+    RUN_TEST(test_acks_are_never_limited);
+    RUN_TEST(test_least_recently_used_entry_is_forgotten);
+    return UNITY_END();
+}
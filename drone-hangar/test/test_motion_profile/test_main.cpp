@@ -0,0 +1,126 @@
+/*
+ * Servo motion profiles (devices/MotionProfile): peak velocity, duration
+ * and monotonic arrival on the target of both shapes, in both directions,
+ * for moves of 1 to 250 frames.
+ */
+#include <stdlib.h>
+#include <unity.h>
+
+#include "devices/MotionProfile.hpp"
+
+#define PULSE_MIN 544
+#define PULSE_MAX 2400
+#define RAMP_DIV 3
+
+static const uint16_t FRAMES[] = {1, 2, 3, 5, 25, 250};
+
+void setUp() {}
+
+void tearDown() {}
+
+/* One move played frame by frame */
+struct Run
+{
+    uint16_t frames;  /**< Frames until the profile stopped */
+    int16_t peak;     /**< Largest step between two frames, in the move direction */
+    bool monotonic;   /**< Never stepped back */
+    uint16_t end;
+};
+
+static Run play(MotionShape shape, uint16_t from, uint16_t to, uint16_t frames)
+{
+    MotionProfile motion;
+    motion.hold(from);
+    motion.start(to, frames, shape, RAMP_DIV);
+
+    int dir = to > from ? 1 : -1;
+    Run run = {0, 0, true, 0};
+    int prev = motion.position();
+    while (motion.isMoving() && run.frames <= frames)
+    {
+        motion.advance();
+        run.frames++;
+        int v = dir * (motion.position() - prev);
+        run.monotonic = run.monotonic && v >= 0;
+        run.peak = v > run.peak ? v : run.peak;
+        prev = motion.position();
+    }
+    run.end = motion.position();
+    return run;
+}
+
+/* Frames of each ramp as start() picks them, 0 for a jump */
+static uint16_t rampOf(MotionShape shape, uint16_t frames)
+{
+    uint16_t r = frames / RAMP_DIV;
+    if (shape == MOTION_SCURVE && (r & ~1) != 0)
+        return r & ~1;
+    return r == 0 && frames >= 2 ? 1 : r;
+}
+
+static void checkShape(MotionShape shape)
+{
+    for (uint16_t frames : FRAMES)
+    {
+        for (int dir = 0; dir < 2; dir++)
+        {
+            uint16_t from = dir ? PULSE_MAX : PULSE_MIN;
+            uint16_t to = dir ? PULSE_MIN : PULSE_MAX;
+            Run run = play(shape, from, to, frames);
+            uint16_t ramp = rampOf(shape, frames);
+
+            TEST_ASSERT_EQUAL(to, run.end);
+            TEST_ASSERT_TRUE(run.monotonic);
+            if (ramp == 0)
+            {
+                // Too short for a ramp: the target is reached at once
+                TEST_ASSERT_EQUAL(0, run.frames);
+                continue;
+            }
+            TEST_ASSERT_EQUAL(frames, run.frames);
+
+            // The cruise velocity covers the travel in frames - ramp, both shapes
+            int travel = PULSE_MAX - PULSE_MIN;
+            int peak = travel / (frames - ramp);
+            TEST_ASSERT_INT_WITHIN(2, peak, run.peak);
+        }
+    }
+}
+
+void test_trapezoid_peak_duration_and_arrival() { checkShape(MOTION_TRAPEZOID); }
+
+void test_scurve_peak_duration_and_arrival() { checkShape(MOTION_SCURVE); }
+
+void test_scurve_is_gentler_at_the_start()
+{
+    // 500 ms at 20 ms per frame: the first steps of the S-curve are smaller
+    MotionProfile trapezoid, scurve;
+    trapezoid.hold(PULSE_MIN);
+    scurve.hold(PULSE_MIN);
+    trapezoid.start(PULSE_MAX, 25, MOTION_TRAPEZOID, RAMP_DIV);
+    scurve.start(PULSE_MAX, 25, MOTION_SCURVE, RAMP_DIV);
+    trapezoid.advance();
+    scurve.advance();
+    TEST_ASSERT_LESS_THAN(trapezoid.position(), scurve.position());
+    TEST_ASSERT_GREATER_THAN(PULSE_MIN, scurve.position());
+}
+
+void test_move_to_the_held_position_does_nothing()
+{
+    MotionProfile motion;
+    motion.hold(1500);
+    motion.start(1500, 25, MOTION_SCURVE, RAMP_DIV);
+    TEST_ASSERT_FALSE(motion.isMoving());
+    TEST_ASSERT_FALSE(motion.advance());
+    TEST_ASSERT_EQUAL(1500, motion.position());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_trapezoid_peak_duration_and_arrival);
+    RUN_TEST(test_scurve_peak_duration_and_arrival);
+    RUN_TEST(test_scurve_is_gentler_at_the_start);
+    RUN_TEST(test_move_to_the_held_position_does_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,212 @@
+/*
+ * Timer2 servo driver (devices/ServoTimer2) with its interrupts called in
+ * a loop: pulse widths, a move along a profile, sleeping when idle and
+ * waking on the next move, detaching with the timer running or stopped,
+ * and two channels of a ServoArrayT2 in one frame. The tests share the
+ * driver state and run in order.
+ */
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <unity.h>
+
+#include "devices/ServoTimer2.hpp"
+
+extern "C" void TIMER2_OVF_vect(void);
+extern "C" void TIMER2_COMPB_vect(void);
+
+#define SERVO_PIN 11
+#define SERVO_BIT _BV(3)  /* PB3 */
+#define LEAF1_PIN 9
+#define LEAF2_PIN 10
+#define IDLE_FRAMES 20
+#define MAX_OVERFLOWS 1000 /* a frame takes about 160 */
+
+static ServoTimer2 servo;
+static ServoArrayT2 leaves;
+
+/* A pin seen by frame(): pulses on PORTB, in us of the 0.5 us timer ticks */
+struct Probe
+{
+    uint8_t bit;
+    bool high;
+    unsigned rise, fall;  // ticks from the start of the frame
+    unsigned lastPulse;   // width of the last pulse
+    unsigned pulses;
+};
+
+static Probe probes[] = {
+    {SERVO_BIT, false, 0, 0, 0, 0},
+    {_BV(LEAF1_PIN - 8), false, 0, 0, 0, 0},
+    {_BV(LEAF2_PIN - 8), false, 0, 0, 0, 0},
+};
+static Probe& servoProbe = probes[0];
+static Probe& leaf1 = probes[1];
+static Probe& leaf2 = probes[2];
+static unsigned& lastPulse = servoProbe.lastPulse;
+static unsigned& pulses = servoProbe.pulses;
+
+void setUp() {}
+
+void tearDown() {}
+
+/*
+ * One frame: the overflow runs up to the end of the last channel, each one
+ * after the ticks left in TCNT2, then the motion interrupt they armed.
+ * false if the timer is stopped.
+ */
+static bool frame()
+{
+    if (!(TIMSK2 & _BV(TOIE2)))
+        return false;
+
+    unsigned ticks = 0;
+    for (Probe& p : probes) p.high = PORTB & p.bit;
+    for (int i = 0; i < MAX_OVERFLOWS && !(TIMSK2 & _BV(OCIE2B)); i++)
+    {
+        ticks += 256 - TCNT2;
+        TIMER2_OVF_vect();
+        for (Probe& p : probes)
+        {
+            bool now = PORTB & p.bit;
+            if (now && !p.high)
+                p.rise = ticks;
+            else if (!now && p.high)
+            {
+                p.fall = ticks;
+                p.lastPulse = (ticks - p.rise) / 2;
+                p.pulses++;
+            }
+            p.high = now;
+        }
+    }
+    TEST_ASSERT_TRUE(TIMSK2 & _BV(OCIE2B));
+    for (Probe& p : probes) TEST_ASSERT_FALSE(p.high);  // never left high across the frame sync
+    TIMER2_COMPB_vect();
+    return true;
+}
+
+/* Frames until the timer stops, at most limit */
+static unsigned framesUntilStopped(unsigned limit)
+{
+    unsigned n = 0;
+    while (n < limit && frame()) n++;
+    return n;
+}
+
+void test_pulse_width_follows_write()
+{
+    TEST_ASSERT_EQUAL(1, servo.attach(SERVO_PIN));
+    servo.write(1500);
+    frame();
+    frame();
+    // The overflow path itself takes about DELAY_ADJUST on the target
+    TEST_ASSERT_INT_WITHIN(2, 1500 - 8, lastPulse);
+    TEST_ASSERT_INT_WITHIN(1, 1500, servo.read());
+
+    servo.write(544);
+    frame();
+    TEST_ASSERT_INT_WITHIN(2, 544 - 8, lastPulse);
+}
+
+void test_channel_sleeps_when_idle_and_wakes_on_a_move()
+{
+    servo.detachWhenIdle(IDLE_FRAMES);
+    TEST_ASSERT_EQUAL(IDLE_FRAMES, framesUntilStopped(2 * IDLE_FRAMES));
+    TEST_ASSERT_EQUAL(0, TIMSK2);
+    TEST_ASSERT_TRUE(servo.attached());  // asleep, not detached
+
+    // The move restarts the timer from the last pulse width and runs the profile
+    servo.moveTo(2400, 10, MOTION_SCURVE, 3);
+    TEST_ASSERT_TRUE(TIMSK2 & _BV(TOIE2));
+    unsigned previous = 0, frames = 0;
+    while (servo.moving() && frame())
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(previous, lastPulse);
+        previous = lastPulse;
+        frames++;
+    }
+    TEST_ASSERT_EQUAL(10, frames);
+    TEST_ASSERT_EQUAL(2400, servo.position());
+
+    // Asleep again IDLE_FRAMES after the end of the move
+    unsigned before = pulses;
+    TEST_ASSERT_EQUAL(IDLE_FRAMES, framesUntilStopped(2 * IDLE_FRAMES));
+    TEST_ASSERT_EQUAL(IDLE_FRAMES, pulses - before);
+    TEST_ASSERT_INT_WITHIN(2, 2400 - 8, lastPulse);
+}
+
+void test_detach_with_the_timer_stopped()
+{
+    TEST_ASSERT_EQUAL(0, TIMSK2);
+    servo.detach();
+    TEST_ASSERT_FALSE(servo.attached());
+    servo.write(1500);  // a detached channel is not woken up
+    TEST_ASSERT_EQUAL(0, TIMSK2);
+
+    TEST_ASSERT_EQUAL(1, servo.attach(SERVO_PIN));
+    TEST_ASSERT_TRUE(servo.attached());
+    unsigned before = pulses;
+    frame();
+    frame();
+    TEST_ASSERT_EQUAL(2, pulses - before);
+}
+
+void test_detach_with_the_timer_running_ends_the_frame()
+{
+    servo.detachWhenIdle(0);
+    servo.detach();
+    TEST_ASSERT_FALSE(servo.attached());
+    unsigned before = pulses;
+    TEST_ASSERT_EQUAL(1, framesUntilStopped(10));  // the frame in progress ends normally
+    TEST_ASSERT_EQUAL(1, pulses - before);
+    TEST_ASSERT_EQUAL(0, PORTB & SERVO_BIT);
+}
+
+void test_array_drives_two_channels_in_one_frame()
+{
+    TEST_ASSERT_EQUAL(0, TIMSK2);
+    TEST_ASSERT_EQUAL(1, leaves.attach(LEAF1_PIN));
+    TEST_ASSERT_EQUAL(2, leaves.attach(LEAF2_PIN));
+    leaves.write(1, 1000);
+    leaves.write(2, 2000);
+    TEST_ASSERT_INT_WITHIN(1, 1000, leaves.read(1));
+    TEST_ASSERT_INT_WITHIN(1, 2000, leaves.read(2));
+
+    // Both pulses in every frame, one after the other; the motion interrupt
+    // skips the channels without a profile
+    unsigned before1 = leaf1.pulses, before2 = leaf2.pulses;
+    TEST_ASSERT_TRUE(frame());
+    TEST_ASSERT_TRUE(frame());
+    TEST_ASSERT_EQUAL(2, leaf1.pulses - before1);
+    TEST_ASSERT_EQUAL(2, leaf2.pulses - before2);
+    TEST_ASSERT_INT_WITHIN(2, 1000 - 8, leaf1.lastPulse);
+    TEST_ASSERT_INT_WITHIN(2, 2000 - 8, leaf2.lastPulse);
+    TEST_ASSERT_LESS_OR_EQUAL(leaf2.rise, leaf1.fall);
+
+    // One leaf detached at the end of the frame, the other one goes on
+    leaves.detach(1);
+    TEST_ASSERT_FALSE(leaves.attached(1));
+    TEST_ASSERT_TRUE(leaves.attached(2));
+    frame();
+    before1 = leaf1.pulses;
+    before2 = leaf2.pulses;
+    frame();
+    TEST_ASSERT_EQUAL(0, leaf1.pulses - before1);
+    TEST_ASSERT_EQUAL(1, leaf2.pulses - before2);
+
+    // The timer stops with the last channel
+    leaves.detach(2);
+    TEST_ASSERT_EQUAL(1, framesUntilStopped(10));
+    TEST_ASSERT_EQUAL(0, TIMSK2);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pulse_width_follows_write);
+    RUN_TEST(test_channel_sleeps_when_idle_and_wakes_on_a_move);
+    RUN_TEST(test_detach_with_the_timer_stopped);
+    RUN_TEST(test_detach_with_the_timer_running_ends_the_frame);
+    RUN_TEST(test_array_drives_two_channels_in_one_frame);
+    return UNITY_END();
+}
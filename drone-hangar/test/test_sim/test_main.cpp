@@ -0,0 +1,132 @@
+/*
+ * The whole firmware on the native build: setup() and the scheduler run
+ * on the virtual clock while the tests drive the simulated devices, as
+ * src/sim/scripts/mission.txt does. The tests share one boot and run in
+ * time order.
+ */
+#include <Arduino.h>
+#include <unity.h>
+
+#include <string>
+
+#include "model/Context.hpp"
+#include "sim/SimClock.hpp"
+#include "sim/SimDevices.hpp"
+#include "sim/SimSerial.hpp"
+
+void setup();
+void loop();
+void serialEvent();
+
+extern Context* pContext;
+
+static std::string output;
+
+static void keepOutput(uint8_t c) { output += (char)c; }
+
+/* The loop of the Arduino core, up to a virtual time */
+static void runUntil(unsigned long ms)
+{
+    while (SimClock.nowUs() < (uint64_t)ms * 1000)
+    {
+        loop();
+        if (Serial.available())
+            serialEvent();
+    }
+}
+
+static void send(const char* line)
+{
+    SimSerial.inject(line, strlen(line));
+    SimSerial.inject("\n", 1);
+}
+
+static const ContextSnapshot& snap() { return pContext->getSnapshot(); }
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_boot_reaches_rest_with_the_pir_ready()
+{
+    SimHW.temp.set(22);
+    SimHW.sonar.set(0.1f);
+    runUntil(11000);
+    TEST_ASSERT_EQUAL(0, snap().droneState);
+    TEST_ASSERT_TRUE(snap().pirReady);
+    TEST_ASSERT_FALSE(snap().doorOpen);
+    TEST_ASSERT_EQUAL(255, SimHW.l1.level());
+    TEST_ASSERT_TRUE(output.find("Drone Hangar Ready") != std::string::npos);
+}
+
+void test_take_off_opens_the_door_and_closes_it_behind_the_drone()
+{
+    send("{\"cmd\":\"open\"}");
+    runUntil(12500);
+    TEST_ASSERT_EQUAL(1, snap().droneState);
+    TEST_ASSERT_TRUE(snap().doorOpen);
+    TEST_ASSERT_EQUAL(DOOR_OPEN_ANGLE, SimHW.servo.getPosition());
+
+    SimHW.sonar.set(2.5f);  // above D1 for TIME1
+    runUntil(12500 + TIME1 + 2000);
+    TEST_ASSERT_EQUAL(2, snap().droneState);
+    TEST_ASSERT_FALSE(snap().doorOpen);
+    TEST_ASSERT_EQUAL(0, SimHW.servo.getPosition());
+}
+
+void test_landing_needs_presence_then_the_drone_below_d2()
+{
+    SimHW.pir.set(true);
+    runUntil(20000);
+    send("{\"cmd\":\"open\"}");
+    runUntil(21000);
+    TEST_ASSERT_EQUAL(3, snap().droneState);
+
+    SimHW.sonar.set(0.1f);  // below D2 for TIME2
+    runUntil(21000 + TIME2 + 2000);
+    SimHW.pir.set(false);
+    runUntil(30000);
+    TEST_ASSERT_EQUAL(0, snap().droneState);
+    TEST_ASSERT_FALSE(snap().doorOpen);
+}
+
+void test_temperature_goes_through_pre_alarm_to_alarm()
+{
+    SimHW.temp.set(TEMP1 + 1);
+    runUntil(30000 + TIME3 + 1000);
+    TEST_ASSERT_TRUE(snap().preAlarmActive);
+    TEST_ASSERT_FALSE(snap().alarmActive);
+
+    SimHW.temp.set(TEMP2 + 1);
+    runUntil(36000 + TIME4 + 1000);
+    TEST_ASSERT_TRUE(snap().alarmActive);
+    TEST_ASSERT_EQUAL(255, SimHW.l3.level());
+}
+
+void test_button_clears_the_alarm_once_the_temperature_is_back()
+{
+    SimHW.temp.set(22);
+    runUntil(45000);
+    SimHW.button.set(true);
+    runUntil(45200);
+    SimHW.button.set(false);
+    runUntil(46000);
+    TEST_ASSERT_FALSE(snap().alarmActive);
+    TEST_ASSERT_FALSE(snap().preAlarmActive);
+    TEST_ASSERT_EQUAL(0, SimHW.l3.level());
+}
+
+int main()
+{
+    SimSerial.setSink(keepOutput);
+    SimClock.addSource(&SimSerial);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_reaches_rest_with_the_pir_ready);
+    RUN_TEST(test_take_off_opens_the_door_and_closes_it_behind_the_drone);
+    RUN_TEST(test_landing_needs_presence_then_the_drone_below_d2);
+    RUN_TEST(test_temperature_goes_through_pre_alarm_to_alarm);
+    RUN_TEST(test_button_clears_the_alarm_once_the_temperature_is_back);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/*
+ * Host-side decoder for the hangar serial output.
+ *
+ * Expands dictionary-encoded log entries back to text using the same
+ * catalog the firmware is built with (src/kernel/LogCatalog.hpp).
+ *
+ * Build (from drone-hangar/):
+ *   g++ -std=c++11 -Isrc tools/logdecode.cpp src/kernel/BinaryProtocol.cpp -o logdecode
+ *
+ * Usage:
+ *   logdecode < capture.txt            text mode, "ld:<id>[,<arg>]" lines
+ *   logdecode --binary < capture.bin   COBS framed binary protocol
+ *
+ * Every other line or frame is printed unchanged (text) or as key=value
+ * pairs (binary).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernel/BinaryProtocol.hpp"
+#include "kernel/LogCatalog.hpp"
+
+#define LOG_TEXT_ENTRY(id, module, level, text) text,
+static const char* const LOG_TEXTS[] = {LOG_CATALOG(LOG_TEXT_ENTRY)};
+#undef LOG_TEXT_ENTRY
+
+static void printEntry(unsigned id, bool hasArg, int arg, const char* time)
+{
+    if (id < LOG_COUNT)
+        printf("lo:%s", LOG_TEXTS[id]);
+    else
+        printf("lo:<unknown log id %u>", id);
+    if (hasArg)
+        printf(" %d", arg);
+    if (time)
+        printf(" @%s", time);
+    printf("\n");
+}
+
+static void decodeText()
+{
+    char line[512];
+    while (fgets(line, sizeof(line), stdin))
+    {
+        if (strncmp(line, "ld:", 3) != 0)
+        {
+            fputs(line, stdout);
+            continue;
+        }
+        char* end;
+        unsigned id = (unsigned)strtoul(line + 3, &end, 10);
+        bool hasArg = *end == ',';
+        int arg = hasArg ? (int)strtol(end + 1, &end, 10) : 0;
+        // Entries sent by a dump carry their timestamp: " @<ms>"
+        char* time = strchr(end, '@');
+        if (time)
+            time[strcspn(time, "\r\n")] = '\0';
+        printEntry(id, hasArg, arg, time ? time + 1 : NULL);
+    }
+}
+
+static void printFrame(const uint8_t* raw, size_t len)
+{
+    FrameReader reader(raw, len);
+    if (len == 0 || !reader.isValid())
+    {
+        printf("# bad frame (%u bytes)\n", (unsigned)len);
+        return;
+    }
+
+    uint8_t id, n;
+    uint32_t value;
+    const uint8_t* data;
+
+    if (reader.type() == FRAME_LOG)
+    {
+        unsigned logId = LOG_COUNT;
+        bool hasArg = false;
+        int arg = 0;
+        char time[12];
+        bool hasTime = false;
+        while (reader.next(id, value, data, n))
+        {
+            if (id == FIELD_LOG_ID)
+                logId = value;
+            else if (id == FIELD_LOG_ARG)
+            {
+                hasArg = true;
+                arg = (int16_t)value;
+            }
+            else if (id == FIELD_TIMESTAMP)
+            {
+                hasTime = true;
+                snprintf(time, sizeof(time), "%lu", (unsigned long)value);
+            }
+            else if (id == FIELD_TEXT)
+            {
+                printf("lo:%.*s\n", n, (const char*)data);
+                return;
+            }
+        }
+        printEntry(logId, hasArg, arg, hasTime ? time : NULL);
+        return;
+    }
+
+    printf("frame type=0x%02x seq=%u", reader.type(), reader.seq());
+    while (reader.next(id, value, data, n))
+    {
+        if ((id & FIELD_WIDTH_MASK) == FIELD_WIDTH_VAR)
+            printf(" 0x%02x=\"%.*s\"", id, n, (const char*)data);
+        else if (id == FIELD_DISTANCE)
+            printf(" 0x%02x=%d", id, (int16_t)value);
+        else
+            printf(" 0x%02x=%lu", id, (unsigned long)value);
+    }
+    printf("\n");
+}
+
+static void decodeBinary()
+{
+    uint8_t encoded[FRAME_MAX_ENCODED + 1];
+    uint8_t raw[FRAME_MAX_ENCODED];
+    size_t n = 0;
+    bool overflow = false;
+    int c;
+    while ((c = getchar()) != EOF)
+    {
+        if (c != 0)
+        {
+            if (n < sizeof(encoded))
+                encoded[n++] = (uint8_t)c;
+            else
+                overflow = true;
+            continue;
+        }
+        if (overflow)
+            printf("# frame too long, dropped\n");
+        else if (n > 0)
+            printFrame(raw, cobsDecode(encoded, n, raw));
+        n = 0;
+        overflow = false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--binary") == 0)
+        decodeBinary();
+    else
+        decodeText();
+    return 0;
+}
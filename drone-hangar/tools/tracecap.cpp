@@ -0,0 +1,118 @@
+/*
+ * Host-side store for the input capture of a TRACE_CAPTURE build.
+ *
+ * Keeps the "tr:" records of a serial capture and writes them as a script
+ * of the native build (src/sim/SimScript.hpp), with absolute times, so
+ * the firmware can be run again on the same inputs.
+ *
+ * Build (from drone-hangar/):
+ *   g++ -std=c++11 -Isrc tools/tracecap.cpp -o tracecap
+ *
+ * Usage:
+ *   tracecap [capture.txt] > trace.txt     default stdin, e.g. a tty
+ *   .pio/build/native/program -s trace.txt -o state.txt
+ *
+ * Every other line is ignored. Edges carry their interrupt time, so the
+ * records are sorted again by time; an inbound line is moved back by the
+ * time it took on the wire at BAUD_RATE, the replay sends it again.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+
+struct Record
+{
+    long at; /**< ms */
+    std::string input;
+    std::string value;
+};
+
+static bool parse(const char* line, long& time, Record& r)
+{
+    char* end;
+    long dt = strtol(line + 3, &end, 10);
+    if (end == line + 3)
+        return false;
+    time += dt;
+    r.at = time;
+
+    char kind = *end++;
+    char value[32];
+    long v = strtol(end, NULL, 10);
+    switch (kind)
+    {
+        case 't':
+            r.input = "temp";
+            snprintf(value, sizeof(value), "%.2f", v / 100.0);
+            break;
+        case 'd':
+            r.input = "distance";
+            snprintf(value, sizeof(value), "%.3f", v / 1000.0);
+            break;
+        case 'p':
+            r.input = "pir";
+            snprintf(value, sizeof(value), "%ld", v);
+            break;
+        case 'b':
+            r.input = "button";
+            snprintf(value, sizeof(value), "%ld", v);
+            break;
+        case 's':
+            r.input = "serial";
+            r.value = end;
+            // 10 bits per char and the delimiter, rounded up
+            r.at -= (long)((r.value.size() + 1) * 10000 + BAUD_RATE - 1) / BAUD_RATE;
+            if (r.at < 0)
+                r.at = 0;
+            return true;
+        default:
+            return false;
+    }
+    r.value = value;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    FILE* in = argc > 1 ? fopen(argv[1], "r") : stdin;
+    if (!in)
+    {
+        fprintf(stderr, "tracecap: cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    char line[256];
+    long time = 0;
+    unsigned bad = 0;
+    while (fgets(line, sizeof(line), in))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strncmp(line, "tr:", 3) != 0)
+            continue;
+        Record r;
+        if (parse(line, time, r))
+            records.push_back(r);
+        else
+            bad++;
+    }
+    if (in != stdin)
+        fclose(in);
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record& a, const Record& b) { return a.at < b.at; });
+
+    printf("# %u records, <ms> <input> <value>\n", (unsigned)records.size());
+    for (const Record& r : records)
+        printf("%ld %s %s\n", r.at, r.input.c_str(), r.value.c_str());
+
+    if (bad)
+        fprintf(stderr, "tracecap: %u bad records skipped\n", bad);
+    return 0;
+}